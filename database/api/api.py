@@ -1,9 +1,10 @@
-from fastapi import FastAPI, HTTPException
+from fastapi import Body, FastAPI, HTTPException, Header, Response
 import mysql.connector
 import json
 import os
+import threading
 from datetime import datetime
-from typing import Optional
+from typing import List, Optional, Tuple
 
 app = FastAPI()
 
@@ -11,6 +12,13 @@ app = FastAPI()
 CACHE_DIR = os.path.dirname(os.path.abspath(__file__))
 CACHE_FILE = os.path.join(CACHE_DIR, "cache.json")
 PENDING_POSTS_FILE = os.path.join(CACHE_DIR, "pending_posts.json")
+DEAD_LETTER_FILE = os.path.join(CACHE_DIR, "dead_letter_posts.json")
+
+# Sync endpoints draaien in de threadpool van FastAPI: elke load -> wijzig
+# -> save van de pending/dead letter files gaat onder deze lock, anders
+# tellen gelijktijdige bakken dezelfde queue dubbel of raken appends kwijt.
+# Geldt per proces; draai de API met één worker.
+QUEUE_LOCK = threading.Lock()
 
 # Database configuratie
 DB_CONFIG = {
@@ -50,6 +58,135 @@ def save_cache(data: dict):
     except IOError as e:
         print(f"Cache save error: {e}")
 
+ITEMS_LOG_LIMIT = 1000  # Max gewijzigde rijen om delta's uit te kunnen leveren
+
+def record_items(cache: dict, rows):
+    """Zet de nieuwe items in de cache; bij wijzigingen gaat de versie omhoog
+    en komen de gewijzigde/verwijderde ids in de log (voor /items?since=)"""
+    rows = [list(row) for row in rows]
+    if not cache.get("items_version"):
+        cache["items_version"] = 1
+        cache["items_log"] = []
+        cache["items_log_base"] = 1
+
+    old = {row[0]: row for row in cache.get("items", [])}
+    new = {row[0]: row for row in rows}
+    changed = [(item_id, row) for item_id, row in new.items() if old.get(item_id) != row]
+    changed += [(item_id, None) for item_id in old if item_id not in new]
+    cache["items"] = rows
+    if not changed:
+        return
+
+    version = cache["items_version"] + 1
+    log = cache["items_log"]
+    log.extend({"version": version, "id": item_id, "row": row} for item_id, row in changed)
+    # Oudste versies (in zijn geheel) weggooien; daarvoor alleen nog volledig
+    while len(log) > ITEMS_LOG_LIMIT:
+        dropped = log[0]["version"]
+        log[:] = [entry for entry in log if entry["version"] != dropped]
+        cache["items_log_base"] = dropped
+    cache["items_version"] = version
+
+def items_delta(cache: dict, since: int):
+    """Gewijzigde rijen en verwijderde ids sinds een versie, of None als de
+    log die versie niet meer dekt"""
+    if since < cache.get("items_log_base", 0) or since > cache.get("items_version", 0):
+        return None
+    latest = {}
+    for entry in cache.get("items_log", []):
+        if entry["version"] > since:
+            latest[entry["id"]] = entry["row"]
+    changed = [row for row in latest.values() if row is not None]
+    removed = [{"id": item_id} for item_id, row in latest.items() if row is None]
+    return changed, removed
+
+def record_selections(cursor, trashbin_name: str, selections):
+    """Tel selecties op per item (één SELECT + UPDATE/INSERT per uniek item
+    in plaats van per selectie). De laatste dirty waarde wint, zoals bij
+    losse posts in dezelfde volgorde."""
+    counts = {}
+    for item_name, dirty in selections:
+        count, _ = counts.get(item_name, (0, dirty))
+        counts[item_name] = (count + 1, dirty)
+
+    for item_name, (count, dirty) in counts.items():
+        cursor.execute("""
+            SELECT times_selected
+            FROM selected_at_location
+            WHERE item = %s AND location = %s;
+        """, (item_name, trashbin_name))
+        result = cursor.fetchone()
+        if result:
+            cursor.execute("""
+                UPDATE selected_at_location
+                SET times_selected = %s, dirty = %s
+                WHERE item = %s AND location = %s;
+            """, (result[0] + count, dirty, item_name, trashbin_name))
+        else:
+            cursor.execute("""
+                INSERT INTO selected_at_location (item, location, times_selected, dirty)
+                VALUES (%s, %s, %s, %s);
+            """, (item_name, trashbin_name, count, dirty))
+    return len(counts)
+
+
+# Fouten die bij de rij zelf horen (te lange naam, constraint); opnieuw
+# proberen helpt niet. Verbindingsfouten vallen hier niet onder.
+ROW_ERRORS = (mysql.connector.DataError, mysql.connector.IntegrityError)
+
+def record_isolated(cursor, trashbin_name: str, selections) -> list:
+    """record_selections onder een savepoint. Faalt het geheel op een rij
+    fout, dan per selectie opnieuw zodat alleen de slechte rijen afvallen.
+    Geeft de afgewezen selecties terug als (item, dirty, fout)."""
+    cursor.execute("SAVEPOINT batch")
+    try:
+        record_selections(cursor, trashbin_name, selections)
+        return []
+    except ROW_ERRORS:
+        cursor.execute("ROLLBACK TO SAVEPOINT batch")
+
+    rejected = []
+    for item_name, dirty in selections:
+        cursor.execute("SAVEPOINT selection")
+        try:
+            record_selections(cursor, trashbin_name, [(item_name, dirty)])
+        except ROW_ERRORS as e:
+            cursor.execute("ROLLBACK TO SAVEPOINT selection")
+            rejected.append((item_name, dirty, str(e)))
+    return rejected
+
+def dead_letters(trashbin_name: str, rejected) -> list:
+    timestamp = datetime.now().isoformat()
+    return [{
+        "item_name": item_name,
+        "trashbin_name": trashbin_name,
+        "dirty": dirty,
+        "error": error,
+        "timestamp": timestamp
+    } for item_name, dirty, error in rejected]
+
+def load_dead_letters() -> list:
+    if os.path.exists(DEAD_LETTER_FILE):
+        try:
+            with open(DEAD_LETTER_FILE, 'r', encoding='utf-8') as f:
+                return json.load(f)
+        except (json.JSONDecodeError, IOError):
+            pass
+    return []
+
+def save_dead_letters(entries: list):
+    """Afgewezen selecties bewaren (handmatig nakijken), niet opnieuw proberen"""
+    if not entries:
+        return
+    stored = load_dead_letters() + entries  # Vóór open(): 'w' maakt het bestand leeg
+    try:
+        with open(DEAD_LETTER_FILE, 'w', encoding='utf-8') as f:
+            json.dump(stored, f, indent=2, ensure_ascii=False)
+        print(f"Dead-lettered {len(entries)} selections")
+    except IOError as e:
+        print(f"Dead letter save error: {e}")
+
+
 def load_pending_posts() -> list:
     """Laad pending POST requests"""
     if os.path.exists(PENDING_POSTS_FILE):
@@ -68,58 +205,60 @@ def save_pending_posts(posts: list):
     except IOError as e:
         print(f"Pending posts save error: {e}")
 
-def process_pending_posts():
-    """Probeer pending POST requests te verwerken wanneer DB weer online is"""
-    pending = load_pending_posts()
-    if not pending:
-        return
-    
-    conn = get_db()
-    if not conn:
-        return
-    
-    cursor = conn.cursor()
-    processed = []
-    
+def queue_posts(trashbin_name: str, selections) -> str:
+    """Selecties achteraan de pending queue zetten (database offline)"""
+    timestamp = datetime.now().isoformat()
+    with QUEUE_LOCK:
+        pending = load_pending_posts()
+        pending.extend({
+            "item_name": item_name,
+            "trashbin_name": trashbin_name,
+            "dirty": dirty,
+            "timestamp": timestamp
+        } for item_name, dirty in selections)
+        save_pending_posts(pending)
+    return timestamp
+
+def drain_pending_posts(cursor, pending: list) -> list:
+    """Pending queue in de lopende transactie van cursor, per locatie
+    opgeteld. Slechte rijen worden afgewezen in plaats van de hele queue
+    tegen te houden. Geeft de dead letters terug."""
+    by_location = {}
     for post in pending:
+        by_location.setdefault(post["trashbin_name"], []).append(
+            (post["item_name"], post["dirty"]))
+
+    dead = []
+    for trashbin_name, selections in by_location.items():
+        dead.extend(dead_letters(trashbin_name, record_isolated(cursor, trashbin_name, selections)))
+    return dead
+
+def process_pending_posts():
+    """Probeer pending POST requests te verwerken wanneer DB weer online is.
+    De enige plek die de queue leegt: laden, committen en opslaan gebeurt
+    onder QUEUE_LOCK, dus geen dubbele tellingen en geen verloren appends."""
+    with QUEUE_LOCK:
+        pending = load_pending_posts()
+        if not pending:
+            return
+
+        conn = get_db()
+        if not conn:
+            return
+
+        cursor = conn.cursor()
         try:
-            item_name = post["item_name"]
-            trashbin_name = post["trashbin_name"]
-            dirty = post["dirty"]
-            
-            cursor.execute("""
-                SELECT times_selected 
-                FROM selected_at_location 
-                WHERE item = %s AND location = %s;
-            """, (item_name, trashbin_name))
-            
-            result = cursor.fetchone()
-            
-            if result:
-                new_count = result[0] + 1
-                cursor.execute("""
-                    UPDATE selected_at_location
-                    SET times_selected = %s, dirty = %s
-                    WHERE item = %s AND location = %s;
-                """, (new_count, dirty, item_name, trashbin_name))
-            else:
-                cursor.execute("""
-                    INSERT INTO selected_at_location (item, location, times_selected, dirty)
-                    VALUES (%s, %s, %s, %s);
-                """, (item_name, trashbin_name, 1, dirty))
-            
+            dead = drain_pending_posts(cursor, pending)
             conn.commit()
-            processed.append(post)
-            print(f"Processed pending post: {item_name} at {trashbin_name}")
+            save_pending_posts([])
+            save_dead_letters(dead)
+            print(f"Processed {len(pending)} pending posts")
         except Exception as e:
-            print(f"Failed to process pending post: {e}")
-    
-    # Verwijder verwerkte posts
-    remaining = [p for p in pending if p not in processed]
-    save_pending_posts(remaining)
-    
-    cursor.close()
-    conn.close()
+            conn.rollback()
+            print(f"Failed to process pending posts: {e}")
+        finally:
+            cursor.close()
+            conn.close()
 
 
 @app.on_event("startup")
@@ -143,7 +282,7 @@ def update_full_cache(conn):
     try:
         # Items
         cursor.execute("SELECT * FROM items;")
-        cache["items"] = cursor.fetchall()
+        record_items(cache, cursor.fetchall())
         
         # TrashBins
         cursor.execute("SELECT * FROM trashBins;")
@@ -157,9 +296,16 @@ def update_full_cache(conn):
 
 
 @app.get("/items")
-def get_items():
-    """Haal items op - met fallback naar cache"""
+def get_items(response: Response, since: Optional[int] = None,
+              if_none_match: Optional[str] = Header(None)):
+    """Haal items op - met fallback naar cache.
+
+    Versie als ETag; met If-None-Match of ?since=<versie> volgt 304 als er
+    niets veranderd is, of alleen de wijzigingen ("changed" + "removed").
+    "version" staat vooraan zodat de ESP hem leest voor de items."""
     conn = get_db()
+    source = "cache"
+    cache = load_cache()
     
     if conn:
         try:
@@ -170,26 +316,40 @@ def get_items():
             conn.close()
             
             # Update cache
-            cache = load_cache()
-            cache["items"] = rows
+            record_items(cache, rows)
             save_cache(cache)
-            
-            return {"items": rows, "source": "database"}
+            source = "database"
         except Exception as e:
             print(f"Database query failed: {e}")
             if conn:
                 conn.close()
     
-    # Fallback naar cache
-    cache = load_cache()
-    if cache["items"]:
-        return {
-            "items": cache["items"], 
-            "source": "cache",
-            "last_updated": cache.get("last_updated", "unknown")
-        }
+    if not cache["items"]:
+        raise HTTPException(status_code=503, detail="Database unavailable and no cached data")
     
-    raise HTTPException(status_code=503, detail="Database unavailable and no cached data")
+    version = cache.get("items_version", 0)
+    etag = f'"{version}"'
+    if if_none_match and since is None:
+        try:
+            since = int(if_none_match.strip('W/"'))
+        except ValueError:
+            since = None
+    if version and (if_none_match == etag or since == version):
+        return Response(status_code=304, headers={"ETag": etag})
+    response.headers["ETag"] = etag
+    
+    result = {"version": version}
+    delta = items_delta(cache, since) if since else None
+    if delta:
+        result["since"] = since
+    result["source"] = source
+    if source == "cache":
+        result["last_updated"] = cache.get("last_updated", "unknown")
+    if delta:
+        result["changed"], result["removed"] = delta
+    else:
+        result["items"] = cache["items"]
+    return result
 
 
 @app.get("/trashBins")
@@ -230,14 +390,17 @@ def get_trashBins():
 
 @app.get("/trashBinItems/{trashbin_id}")
 def get_item_names_in_trashbin(trashbin_id: int):
-    """Haal items in een specifieke trashbin op - met fallback naar cache"""
+    """Haal items in een specifieke trashbin op - met fallback naar cache.
+
+    "items" zijn de namen, "ids" de item ids in dezelfde volgorde (de ESP
+    filtert zijn catalogus op id)."""
     conn = get_db()
     
     if conn:
         try:
             cursor = conn.cursor()
             cursor.execute("""
-                SELECT i.name FROM trashBinItems t 
+                SELECT i.id, i.name FROM trashBinItems t 
                 JOIN items i ON t.item_id = i.id 
                 WHERE t.trashbin_id = %s;
             """, (trashbin_id,))
@@ -245,16 +408,17 @@ def get_item_names_in_trashbin(trashbin_id: int):
             cursor.close()
             conn.close()
             
-            item_names = [r[0] for r in rows]
+            item_ids = [r[0] for r in rows]
+            item_names = [r[1] for r in rows]
             
             # Update cache voor deze trashbin
             cache = load_cache()
-            if "trashBinItems" not in cache:
-                cache["trashBinItems"] = {}
-            cache["trashBinItems"][str(trashbin_id)] = item_names
+            cache.setdefault("trashBinItems", {})[str(trashbin_id)] = item_names
+            cache.setdefault("trashBinItemIds", {})[str(trashbin_id)] = item_ids
             save_cache(cache)
             
-            return {"trashbin_id": trashbin_id, "items": item_names, "source": "database"}
+            return {"trashbin_id": trashbin_id, "items": item_names, "ids": item_ids,
+                    "source": "database"}
         except Exception as e:
             print(f"Database query failed: {e}")
             if conn:
@@ -267,6 +431,7 @@ def get_item_names_in_trashbin(trashbin_id: int):
         return {
             "trashbin_id": trashbin_id,
             "items": cached_items,
+            "ids": cache.get("trashBinItemIds", {}).get(str(trashbin_id), []),
             "source": "cache",
             "last_updated": cache.get("last_updated", "unknown")
         }
@@ -325,26 +490,58 @@ def post_trash_data(trashbin_name: str, item_name: str, dirty: bool):
                 conn.close()
     
     # Database offline - queue de post voor later
-    pending = load_pending_posts()
-    post_data = {
-        "item_name": item_name,
-        "trashbin_name": trashbin_name,
-        "dirty": dirty,
-        "timestamp": datetime.now().isoformat()
-    }
-    pending.append(post_data)
-    save_pending_posts(pending)
-    
+    queued_at = queue_posts(trashbin_name, [(item_name, dirty)])
+
     return {
         "message": "Data queued for later processing",
         "item": item_name,
         "location": trashbin_name,
         "dirty": dirty,
         "source": "queued",
-        "queued_at": post_data["timestamp"]
+        "queued_at": queued_at
     }
 
 
+SENT_BATCH_LIMIT = 500  # Max selecties per /sentBatch request
+
+
+@app.post("/sentBatch/{trashbin_name}")
+def post_trash_batch(trashbin_name: str, selections: List[Tuple[str, bool]] = Body(...)):
+    """Meerdere selecties in één request, compact als [[item, dirty], ...]
+    (de ESP stuurt zijn offline queue zo in batches). Rijen die zelf falen
+    worden afgewezen (dead letter file) en de rest telt mee, zodat één
+    slechte selectie de batch niet blijft tegenhouden. De server queue
+    wordt pas na de commit geleegd, via process_pending_posts(). Bij een andere database fout: 503 en de
+    ESP houdt de batch in zijn outbox."""
+    if len(selections) > SENT_BATCH_LIMIT:
+        raise HTTPException(status_code=413, detail=f"Max {SENT_BATCH_LIMIT} selections per batch")
+    if not selections:
+        return {"accepted": 0, "source": "database"}
+
+    conn = get_db()
+    if conn:
+        cursor = conn.cursor()
+        try:
+            rejected = record_isolated(cursor, trashbin_name, selections)
+            conn.commit()
+        except Exception as e:
+            print(f"Batch query failed: {e}")
+            conn.rollback()
+            raise HTTPException(status_code=503, detail="Database error, retry later")
+        finally:
+            cursor.close()
+            conn.close()
+        with QUEUE_LOCK:
+            save_dead_letters(dead_letters(trashbin_name, rejected))
+        process_pending_posts()
+        return {"accepted": len(selections) - len(rejected), "rejected": len(rejected),
+                "source": "database"}
+
+    # Database offline - hele batch in één keer in de queue
+    timestamp = queue_posts(trashbin_name, selections)
+    return {"accepted": len(selections), "source": "queued", "queued_at": timestamp}
+
+
 @app.get("/status")
 def get_status():
     """Check systeem status - database connectie en cache info"""
@@ -362,7 +559,8 @@ def get_status():
         "cache_last_updated": cache.get("last_updated"),
         "cached_items_count": len(cache.get("items", [])),
         "cached_trashbins_count": len(cache.get("trashBins", [])),
-        "pending_posts_count": len(pending)
+        "pending_posts_count": len(pending),
+        "dead_letter_count": len(load_dead_letters())
     }
 
 
@@ -384,4 +582,7 @@ def force_sync():
         raise HTTPException(status_code=500, detail=f"Sync failed: {str(e)}")
 
 
-# Start server: uvicorn api:app --host 0.0.0.0 --port 8080
+# Start server: uvicorn api:app --host 0.0.0.0 --port 8080 --timeout-keep-alive 330
+# (i.p.v. de standaard 5 s: net langer dan de catalogus sync periode, zodat het
+# apparaat zijn ene verbinding tussen syncs en posts open kan houden; zie
+# src/services/ApiClient.h)
@@ -2,6 +2,7 @@
 #define APPLICATION_H
 
 #include <memory>
+#include <esp_heap_caps.h>
 #include "events/Event.h"
 #include "states/StateManager.h"
 #include "display/DisplayManager.h"
@@ -10,7 +11,19 @@
 #include "services/SleepModeService.h"
 #include "services/InteractionService.h"
 #include "services/DatabaseService.h"
+#include "services/TaskScheduler.h"
+#include "services/NetworkService.h"
+#include "services/WiFiManager.h"
+#include "services/PopularityService.h"
+#include "services/OutboxFlusher.h"
 #include "models/ItemRepository.h"
+#include "diagnostics/Tracer.h"
+#include "diagnostics/SerialConsole.h"
+#include "diagnostics/BootTimer.h"
+#include "diagnostics/LoopProfiler.h"
+#include "diagnostics/CatalogMemoryReport.h"
+#include "diagnostics/CatalogLoadReport.h"
+#include "diagnostics/CatalogPagingReport.h"
 
 class Application {
 private:
@@ -27,6 +40,18 @@ private:
     ItemRepository::getInstance();
   DatabaseService& databaseService = 
     DatabaseService::getInstance();
+  SerialConsole& console = 
+    SerialConsole::getInstance();
+  TaskScheduler& scheduler = 
+    TaskScheduler::getInstance();
+  NetworkService& networkService = 
+    NetworkService::getInstance();
+  WiFiManager& wifiManager = 
+    WiFiManager::getInstance();
+
+  int renderTaskId = -1;
+  TaskHandle_t loopTaskHandle = nullptr;
+  bool catalogRefreshed = false;
 
 public:
   Application(TFT_eSPI* tft, XPT2046_Touchscreen* touch, 
@@ -36,40 +61,25 @@ public:
     ledAnimation = std::make_unique<LEDAnimationService>(plastic, paper, green, waste);
   }
 
+  // Instant-on: UI komt op uit de lokale snapshot; WiFi, pending posts en
+  // de catalogus refresh lopen daarna op de achtergrond
   void init() {
+    TRACE_SCOPE(TraceName::APP_INIT);
     Serial.println("Initializing Application...");
-    
-    // Connect to WiFi first
-    Serial.println("Connecting to WiFi...");
-    display->init();  // Init display early to show status
-    display->showMessage("Connecting WiFi...");
-    
-    bool wifiConnected = databaseService.connectWiFi(15000);  // 15 sec timeout
-    
-    if (wifiConnected) {
-      display->showMessage("WiFi OK!\nLoading data...");
-      
-      // Process any pending posts from previous session
-      int processed = databaseService.processPendingPosts();
-      if (processed > 0) {
-        Serial.printf("Processed %d pending posts\n", processed);
-      }
-    } else {
-      display->showMessage("WiFi failed\nUsing cached data");
-      delay(1500);
-    }
-    
-    // Load items (database -> JSON -> hardcoded)
-    itemRepository.loadHardcodedItems();
+    BootTimer& boot = BootTimer::getInstance();
+
+    display->init();
+    boot.mark("display");
+
+    // Lokale snapshot (cache -> JSON -> hardcoded), geen netwerk
+    itemRepository.loadLocalItems();
     Serial.printf("Loaded %d items (source: %s)\n", 
                   itemRepository.getItemCount(),
                   itemRepository.getDataSource().c_str());
-    
-    // Show data source status briefly
-    if (itemRepository.isUsingCachedData()) {
-      display->showMessage("Using cached data");
-      delay(1000);
-    }
+    boot.mark("catalog");
+
+    // Voor de "Vaak gekozen" pagina; nodig voordat HomeScreen opent
+    PopularityService::getInstance().load();
     
     // Initialize LED animation
     ledAnimation->init();
@@ -79,9 +89,15 @@ public:
       display.get(), 
       ledAnimation.get()
     );
+    boot.mark("screens");
 
     sleepModeService.setSleepTimeout(10000);  // 10 seconds
 
+    // Netwerk I/O op core 0; WIFI_CONNECTED start pending posts + refresh
+    networkService.begin();
+    wifiManager.begin();
+    boot.mark("network started");
+
     EventBus::getInstance().subscribe(
       EventType::ITEM_SELECTED,
       [this](const Event& e) { onItemSelected(e); }
@@ -97,26 +113,215 @@ public:
       [this](const Event& e) { onScreenChanged(e); }
     );
 
+    EventBus::getInstance().subscribe(
+      EventType::WIFI_CONNECTED,
+      [this](const Event& e) { onWiFiConnected(e); }
+    );
+
+    EventBus::getInstance().subscribe(
+      EventType::WIFI_DISCONNECTED,
+      [this](const Event& e) { networkService.enqueueConnectionClose(); }
+    );
+
+    EventBus::getInstance().subscribe(
+      EventType::NETWORK_RESULT,
+      [this](const Event& e) { onNetworkResult(e); }
+    );
+
+    loopTaskHandle = xTaskGetCurrentTaskHandle();
+    registerTasks();
+    registerConsoleCommands();
+
     Serial.println("Application ready!");
   }
 
-  void update() {
-    touchInput->update();
-    sleepModeService.update();
-    ledAnimation->update();  // Update LED animations!
-    stateManager->update();
+  // Eén scheduler ronde - aangeroepen vanuit loop()
+  void run() {
+    scheduler.run();
   }
 
-  void render() {
-    stateManager->render();
+private:
+  static void printHeap(Print& out) {
+    multi_heap_info_t info;
+    heap_caps_get_info(&info, MALLOC_CAP_8BIT);
+    out.printf("heap free=%u min=%u largest=%u\n",
+               (unsigned)info.total_free_bytes, (unsigned)info.minimum_free_bytes,
+               (unsigned)info.largest_free_block);
+    out.printf("blocks allocated=%u free=%u, allocated bytes=%u\n",
+               (unsigned)info.allocated_blocks, (unsigned)info.free_blocks,
+               (unsigned)info.total_allocated_bytes);
+    float frag = info.total_free_bytes
+      ? 100.0f * (1.0f - (float)info.largest_free_block / info.total_free_bytes) : 0.0f;
+    out.printf("fragmentation=%.1f%%\n", frag);
+  }
+
+  // Taken met eigen periode/deadline/prioriteit (hoger = eerst)
+  void registerTasks() {
+    scheduler.addTask("touch", TOUCH_PERIOD_MS, TOUCH_PERIOD_MS, 4, [this]() {
+      TRACE_SCOPE(TraceName::TOUCH_UPDATE);
+      touchInput->update();
+      requestRenderIfNeeded();
+    });
+
+    renderTaskId = scheduler.addTask("render", 0, RENDER_DEADLINE_MS, 3, [this]() {
+      TRACE_SCOPE(TraceName::APP_RENDER);
+      stateManager->render();
+      BootTimer::getInstance().reportReady();  // Eenmalig: eerste frame
+    });
+
+    scheduler.addTask("led", LED_FRAME_MS, LED_FRAME_MS, 2, [this]() {
+      ledAnimation->update();
+    });
+
+    scheduler.addTask("state", STATE_PERIOD_MS, STATE_PERIOD_MS, 1, [this]() {
+      TRACE_SCOPE(TraceName::STATE_UPDATE);
+      stateManager->update();
+      requestRenderIfNeeded();
+    });
+
+    scheduler.addTask("sleep", SLEEP_CHECK_MS, 0, 1, [this]() {
+      TRACE_SCOPE(TraceName::SLEEP_UPDATE);
+      sleepModeService.update();
+      requestRenderIfNeeded();
+    });
+
+    scheduler.addTask("wifi", WIFI_UPDATE_MS, 0, 1, [this]() {
+      wifiManager.update();
+    });
+
+    scheduler.addTask("net", NETWORK_POLL_MS, 0, 0, [this]() {
+      networkService.poll();
+      publishCatalogIfSafe();
+    });
+
+    // Periodieke catalogus sync; meestal een 304 zonder body
+    scheduler.addTask("catalog", CATALOG_REFRESH_MS, 0, 0, [this]() {
+      if (wifiManager.isConnected()) itemRepository.refreshFromDatabase();
+    });
+
+    // Populariteit naar NVS; de service schrijft zelf hooguit eens per
+    // POPULAR_CHECKPOINT_MS en alleen na een wijziging
+    scheduler.addTask("popular", POPULAR_CHECK_MS, 0, 0, []() {
+      PopularityService::getInstance().checkpoint();
+    });
+
+    // Offline outbox leegmaken zodra de API bereikbaar is (zie OutboxFlusher)
+    scheduler.addTask("outbox", OUTBOX_FLUSH_CHECK_MS, 0, 0, []() {
+      OutboxFlusher::getInstance().tick();
+    });
+
+    scheduler.addTask("console", CONSOLE_PERIOD_MS, 0, 0, [this]() {
+      console.update();
+    });
+
+    // Eerste scherm direct tekenen
+    scheduler.trigger(renderTaskId);
+  }
+
+  // Render draait alleen als het huidige scherm iets te tekenen heeft
+  void requestRenderIfNeeded() {
+    if (stateManager->needsRender()) {
+      scheduler.trigger(renderTaskId);
+    }
+  }
+
+  void registerConsoleCommands() {
+    console.registerCommand("stats", "Loop profiel per stage (min/avg/p99/max)",
+      [](const char*) { LoopProfiler::getInstance().printStats(Serial); });
+
+    console.registerCommand("reset", "Reset profiler en scheduler statistieken",
+      [this](const char*) {
+        LoopProfiler::getInstance().reset();
+        scheduler.resetStats();
+        Serial.println("Stats reset");
+      });
+
+    console.registerCommand("heap", "Heap gebruik en fragmentatie",
+      [this](const char*) {
+        printHeap(Serial);
+        stateManager->printTransitionStats(Serial);
+      });
+
+    console.registerCommand("tasks", "Scheduler taken en FreeRTOS taken",
+      [this](const char*) {
+        scheduler.printStats(Serial);
+        Serial.printf("FreeRTOS tasks: %u\n", (unsigned)uxTaskGetNumberOfTasks());
+        Serial.printf("  %-10s stack free %u bytes\n", pcTaskGetName(loopTaskHandle),
+                      (unsigned)uxTaskGetStackHighWaterMark(loopTaskHandle));
+        networkService.printTaskInfo(Serial);
+      });
+
+    console.registerCommand("wifi", "Verbindingsstatus en connect-tijden",
+      [this](const char*) { wifiManager.printStats(Serial); });
+
+    console.registerCommand("net", "Outbox diepte, post latency en API verbinding (hergebruik, latency)",
+      [this](const char*) { networkService.printStats(Serial); });
+
+    console.registerCommand("outbox", "Offline outbox: diepte, leeftijd, drain rate en backoff (outbox dead|replay)",
+      [](const char* args) {
+        OutboxLog& log = OutboxLog::getInstance();
+        if (strcmp(args, "dead") == 0) {
+          log.printDead(Serial);
+        } else if (strcmp(args, "replay") == 0) {
+          Serial.printf("outbox: %u dead records back in the queue\n", (unsigned)log.replayDead());
+        } else {
+          OutboxFlusher::getInstance().printStats(Serial);
+          log.printStats(Serial);
+        }
+      });
+
+    console.registerCommand("catsync", "Catalogus versie, sync status en wissel latency",
+      [this](const char*) { itemRepository.printSyncStats(Serial); });
+
+    console.registerCommand("popular", "Populairste items en tikken per keuze (popular on|off|save)",
+      [this](const char* args) {
+        PopularityService& popularity = PopularityService::getInstance();
+        if (strcmp(args, "on") == 0 || strcmp(args, "off") == 0) {
+          popularity.setPageEnabled(strcmp(args, "on") == 0);
+          stateManager->goToHomeScreen();
+        } else if (strcmp(args, "save") == 0) {
+          popularity.checkpoint(true);
+        }
+        popularity.printStats(Serial, itemRepository.getCatalog());
+      });
+
+    console.registerCommand("catmem", "Catalogus geheugen vs oude layout (catmem [n] = + n synthetische items)",
+      [this](const char* args) {
+        CatalogMemoryReport::print(Serial, itemRepository.getCatalog(), atoi(args));
+      });
+
+    console.registerCommand("catpage", "Catalogus paging: bladertijd, page-ins en hit rate per toegangspatroon",
+      [this](const char*) { CatalogPagingReport::print(Serial, itemRepository.getCatalog()); });
+
+    console.registerCommand("catload", "Laadtijd catalogus: JSON vs binair snapshot (bestand, RAM, flash)",
+      [](const char*) { CatalogLoadReport::print(Serial); });
+
+#if TRACE_ENABLED
+    console.registerCommand("trace", "Dump trace buffer (trace on|off|clear)",
+      [](const char* args) {
+        Tracer& tracer = Tracer::getInstance();
+        if (strcmp(args, "on") == 0) {
+          tracer.setEnabled(true);
+        } else if (strcmp(args, "off") == 0) {
+          tracer.setEnabled(false);
+        } else if (strcmp(args, "clear") == 0) {
+          tracer.clear();
+        } else {
+          tracer.dump(Serial);
+          return;
+        }
+        Serial.printf("Trace: %s, %u records\n",
+                      tracer.isEnabled() ? "on" : "off", tracer.getRecordCount());
+      });
+#endif
   }
 
-private:
   void onTouchPressed(const Event& event) {
     Serial.printf("Touch: x=%d, y=%d (screen=%d)\n", 
                   event.param1, event.param2, 
                   (int)stateManager->getCurrentScreenType());
     sleepModeService.recordActivity();
+    OutboxFlusher::getInstance().noteActivity();
     
     // If we're in sleep mode, wake up and go to home screen
     if (stateManager->getCurrentScreenType() == ScreenType::SLEEP) {
@@ -131,17 +336,14 @@ private:
   void onItemSelected(const Event& event) {
     int itemId = event.param1;
     bool isDirty = (event.param2 == 1);  // Haal isDirty uit event
-    Item* item = itemRepository.getItemById(itemId);
+    const Item* item = itemRepository.getItemById(itemId);
     
     if (item) {
       Serial.printf("Item selected: %s (category: %d, dirty: %d)\n", 
-                    item->name.c_str(), (int)item->category, isDirty);
-      
-      // Update item dirty status
-      item->isDirty = isDirty;
+                    itemRepository.nameOf(*item), (int)item->category, isDirty);
       
       // Post selection to database (async, queued if offline)
-      itemRepository.postItemSelection(DEVICE_LOCATION, *item);
+      itemRepository.postItemSelection(DEVICE_LOCATION, *item, isDirty);
       
       // Determine color based on dirty status
       ItemCategory displayCategory = item->category;
@@ -169,11 +371,79 @@ private:
         2000  // 2 second breathing cycle
       );
 
+      PopularityService::getInstance().recordSelection(itemId);
       interactionService.recordInteraction(itemId);
       sleepModeService.recordActivity();
     }
   }
 
+  // Na een (re)connect de offline opgebouwde queue versturen en de
+  // catalogus bijwerken (wat er tijdens de onderbreking veranderd is)
+  void onWiFiConnected(const Event& event) {
+    Serial.printf("WiFi up after %d ms, flushing pending posts\n", event.param1);
+    BootTimer::getInstance().mark("wifi connected");
+    OutboxFlusher::getInstance().kick();
+    networkService.enqueueBinFilterFetch();
+    itemRepository.refreshFromDatabase();
+  }
+
+  // Klaarstaande catalogus live zetten zodra het huidige scherm dat toelaat;
+  // schermen zien DATA_RECEIVED en de nieuwe versie bij hun volgende update
+  void publishCatalogIfSafe() {
+    if (!itemRepository.hasStagedCatalog() || !stateManager->canSwapCatalog()) return;
+    itemRepository.publishStagedCatalog();
+    if (itemRepository.isFilterOutdated()) itemRepository.refreshFromDatabase();
+
+    Event dataEvent;
+    dataEvent.type = EventType::DATA_RECEIVED;
+    dataEvent.param1 = itemRepository.getItemCount();
+    EventBus::getInstance().dispatch(dataEvent);
+  }
+
+  void onNetworkResult(const Event& event) {
+    const NetworkResult* result = static_cast<const NetworkResult*>(event.data);
+    switch ((NetworkJobType)event.param1) {
+      case NetworkJobType::POST_SELECTION:
+        Serial.printf("Selection post %s (%lu ms, outbox %u)\n",
+                      result->success ? "done" : "queued on flash",
+                      (unsigned long)result->latencyMs, networkService.getOutboxDepth());
+        break;
+      case NetworkJobType::PROCESS_PENDING:
+        OutboxFlusher::getInstance().onResult(result->success, result->value, result->latencyMs,
+                                              result->generation);
+        if (result->value > 0) {
+          Serial.printf("Processed %d pending posts\n", result->value);
+        }
+        break;
+      case NetworkJobType::CHECK_STATUS:
+        break;
+      case NetworkJobType::FETCH_CATALOG:
+        if (itemRepository.stageCatalogUpdate(result->update)) {
+          publishCatalogIfSafe();
+        } else if (result->update && itemRepository.isFilterOutdated()) {
+          itemRepository.refreshFromDatabase();  // Bak filter veranderde tijdens deze sync
+        }
+        if (!result->update && result->value < 0) {
+          itemRepository.markTooLargeForRam();
+          Serial.println("Catalog too large for RAM, keeping flash catalog");
+        } else if (!result->update) {
+          Serial.println("Catalog refresh failed, keeping local snapshot");
+        } else if (!catalogRefreshed) {
+          catalogRefreshed = true;
+          BootTimer::getInstance().mark("catalog refreshed");
+        }
+        break;
+      case NetworkJobType::FETCH_BIN_FILTER:
+        // Ander filter: volledige catalogus opnieuw, gefilterd op de netwerk taak
+        if (result->binFilter && itemRepository.setBinFilter(*result->binFilter)) {
+          itemRepository.refreshFromDatabase();
+        }
+        break;
+      case NetworkJobType::CLOSE_CONNECTION:
+        break;
+    }
+  }
+
   void onScreenChanged(const Event& event) {
     if (event.param1 == 1) {
       stateManager->goToSleepMode();
@@ -6,9 +6,47 @@
 // ===========================================
 #define WIFI_SSID       "SmarTT"
 #define WIFI_PASS       "MLYNKnapp"
+#define WIFI_CONNECT_TIMEOUT_MS 10000  // Per poging
+#define WIFI_BACKOFF_MIN_MS     1000   // Eerste retry, verdubbelt per mislukte poging
+#define WIFI_BACKOFF_MAX_MS     60000
+#define NTP_SERVER      "pool.ntp.org"  // Klok voor tijdstempels in de offline outbox
+// Optioneel statisch IP (slaat DHCP over), anders DHCP
+// #define WIFI_STATIC_IP  "192.168.1.50"
+// #define WIFI_GATEWAY    "192.168.1.1"
+// #define WIFI_SUBNET     "255.255.255.0"
+// #define WIFI_DNS        "192.168.1.1"
 #define API_HOST        "4.231.92.177"
 #define API_PORT        8080
 #define DEVICE_LOCATION "Heidelberglaan"  // Location name for this device
+#define API_REQUEST_BUFFER 384          // Request line + headers (zie services/ApiClient.h)
+#define API_DRAIN_LIMIT    1024         // Ongelezen body tot zoveel bytes weglezen i.p.v. verbinding sluiten
+
+// Netwerk taak (alle HTTP calls, los van de UI op core 1)
+#define NETWORK_TASK_CORE     0
+#define NETWORK_TASK_STACK    8192
+#define NETWORK_TASK_PRIORITY 1
+#define NETWORK_OUTBOX_SIZE   16     // Max jobs in de outbox queue
+#define NETWORK_POLL_MS       50     // Resultaten ophalen op de UI thread
+#define PENDING_BATCH_SIZE    32     // Offline selecties per /sentBatch request
+#define OUTBOX_DIR            "/outbox"     // Offline selecties (zie services/OutboxLog.h)
+#define OUTBOX_SEGMENT_BYTES  4096          // Nieuw segment daarboven
+#define OUTBOX_MAX_BYTES      (256 * 1024)  // Flash budget voor de hele queue
+#define OUTBOX_DEAD_MAX_BYTES (32 * 1024)   // Door de API geweigerde batches (outbox dead/replay)
+#define OUTBOX_FLUSH_CHECK_MS 1000     // Flusher kijkt of er iets te versturen is
+#define OUTBOX_FLUSH_BATCHES  4        // Batches per flush job (daarna weer ruimte voor live posts)
+#define OUTBOX_MAX_IN_FLIGHT  1        // Flush jobs tegelijk in de netwerk outbox
+#define OUTBOX_IDLE_MS        3000     // Niet flushen tot zo lang na de laatste aanraking
+#define OUTBOX_BACKOFF_MIN_MS 2000     // Eerste retry na een mislukte flush, verdubbelt
+#define OUTBOX_BACKOFF_MAX_MS 300000
+
+// Binaire catalogus (zie models/CatalogFormat.h en tools/catalog_pack.py)
+#define CATALOG_CACHE_FILE        "/db_cache.bin"   // Laatste API snapshot in LittleFS
+#define CATALOG_JSON_CACHE_FILE   "/db_cache.json"  // Oud formaat, alleen nog lezen
+#define CATALOG_PARTITION_LABEL   "catalog"         // Zie partitions.csv
+#define CATALOG_PARTITION_SUBTYPE 0x40              // Custom data subtype
+#define CATALOG_REFRESH_MS        300000            // Achtergrond sync (304 als er niets veranderd is)
+#define CATALOG_MIN_FREE_HEAP     (48 * 1024)       // Moet vrij blijven naast een catalogus in RAM
+#define BIN_FILTER_FILE           "/bin_items.json" // Items die in de bak op DEVICE_LOCATION mogen
 
 // ===========================================
 // DISPLAY
@@ -22,6 +60,13 @@
 #define FOOTER_HEIGHT 50
 #define GRID_COLS 2
 #define GRID_ROWS 3
+#define SEARCH_QUERY_MAX 20  // Max tekens in de zoekbalk
+#define FUZZY_INDEX_BUDGET (24 * 1024)  // Max bytes trigram index (tikfout-tolerant zoeken)
+#define FUZZY_TOP_K 8                   // Max treffers bij fuzzy zoeken
+#define POPULAR_PAGE_ENABLED 1          // "Vaak gekozen" pagina voor de A-Z pagina's
+#define POPULAR_TRACKED 32              // Items met een teller (de rest telt niet mee)
+#define POPULAR_HALF_LIFE 200           // Selecties tot een teller half zo zwaar weegt
+#define POPULAR_CHECKPOINT_MS 600000    // Max één NVS write per 10 min (alleen als er iets veranderde)
 
 // ===========================================
 // KLEUREN (RGB565)
@@ -76,4 +121,23 @@
 #define ITEM_CHANGE_TIME 5000       // 5 sec per item in sleep
 #define LED_BREATHING_SPEED 2000    // Adem cyclus in ms
 
+// Scheduler periodes (zie services/TaskScheduler.h)
+#define TOUCH_PERIOD_MS    5        // 200 Hz touch sampling
+#define LED_FRAME_MS       16       // ~60 Hz LED frames
+#define STATE_PERIOD_MS    50       // Screen update (item rotatie, timers)
+#define SLEEP_CHECK_MS     100      // Inactiviteit check
+#define CONSOLE_PERIOD_MS  50       // Serial console polling
+#define WIFI_UPDATE_MS     100      // WiFi state machine
+#define POPULAR_CHECK_MS   60000    // Populariteit checkpoint check (zie POPULAR_CHECKPOINT_MS)
+#define RENDER_DEADLINE_MS 33       // Render alleen na invalidatie
+#define BOOT_TARGET_MS     1000     // Doel: UI zichtbaar binnen 1 s na reset
+
+// ===========================================
+// DIAGNOSTICS
+// ===========================================
+#define TRACE_ENABLED 1             // 0 = trace macros compileren weg
+#define TRACE_BUFFER_SIZE 512       // Aantal trace records in RAM (8 bytes per stuk)
+#define PROFILER_MAX_STAGES 16      // Scheduler taken (nu 11) + idle, met ruimte
+#define PROFILER_BUCKETS 120        // Log-schaal histogram per stage (p99)
+
 #endif
\ No newline at end of file
@@ -0,0 +1,69 @@
+#ifndef BOOT_TIMER_H
+#define BOOT_TIMER_H
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include "../config.h"
+
+// Boot-fase tijden, gemeten vanaf reset (esp_timer telt vanaf ROM boot).
+// De synchrone fases worden als rapport geprint zodra het eerste frame
+// staat; achtergrond fases (WiFi, catalogus refresh) komen erachteraan.
+class BootTimer {
+private:
+  static const int MAX_PHASES = 16;
+
+  struct Phase {
+    const char* name;
+    uint32_t atUs;
+  };
+
+  Phase phases[MAX_PHASES];
+  int phaseCount = 0;
+  bool reported = false;
+
+  BootTimer() {}
+
+public:
+  static BootTimer& getInstance() {
+    static BootTimer instance;
+    return instance;
+  }
+
+  BootTimer(const BootTimer&) = delete;
+  void operator=(const BootTimer&) = delete;
+
+  void mark(const char* name) {
+    uint32_t now = (uint32_t)esp_timer_get_time();
+    if (phaseCount < MAX_PHASES) {
+      phases[phaseCount++] = {name, now};
+    }
+    // Na het rapport: achtergrond fases direct loggen
+    if (reported) {
+      Serial.printf("Boot: %-16s at %6lu ms\n", name, (unsigned long)(now / 1000));
+    }
+  }
+
+  // Eenmalig, bij het eerste frame
+  void reportReady() {
+    if (reported) return;
+    mark("ui ready");
+    reported = true;
+
+    Serial.println("----- Boot timing -----");
+    uint32_t prev = 0;
+    for (int i = 0; i < phaseCount; i++) {
+      Serial.printf("  %-16s +%5lu ms  (at %5lu ms)\n", phases[i].name,
+                    (unsigned long)((phases[i].atUs - prev) / 1000),
+                    (unsigned long)(phases[i].atUs / 1000));
+      prev = phases[i].atUs;
+    }
+    uint32_t readyMs = prev / 1000;
+    Serial.printf("  UI ready after %lu ms (target %d ms)%s\n", (unsigned long)readyMs,
+                  BOOT_TARGET_MS, readyMs > BOOT_TARGET_MS ? " - OVER TARGET" : "");
+    Serial.println("-----------------------");
+  }
+
+  bool isReady() const { return reported; }
+};
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef CATALOG_LOAD_REPORT_H
+#define CATALOG_LOAD_REPORT_H
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <esp_heap_caps.h>
+#include <vector>
+#include "../models/Catalog.h"
+#include "../models/ItemRepository.h"
+#include "../services/DatabaseService.h"
+
+// Laadtijd van de catalogus per pad: JSON parse (huidige boot pad) tegen
+// het binaire snapshot uit LittleFS, uit RAM en in place uit de flash
+// partitie of de firmware. Zelfde inhoud waar mogelijk; tijd in us plus
+// heap bytes en blokken die de geladen catalogus vasthoudt.
+class CatalogLoadReport {
+private:
+  static constexpr const char* TEMP_FILE = "/catload.bin";
+
+  struct HeapSample {
+    size_t bytes;
+    size_t blocks;
+  };
+
+  static HeapSample sample() {
+    multi_heap_info_t info;
+    heap_caps_get_info(&info, MALLOC_CAP_8BIT);
+    return {info.total_allocated_bytes, info.allocated_blocks};
+  }
+
+  static void printRow(Print& out, const char* label, bool ok, uint32_t us,
+                       const Catalog& loaded, const HeapSample& before, const HeapSample& after) {
+    if (!ok) {
+      out.printf("  %-10s -\n", label);
+      return;
+    }
+    out.printf("  %-10s %5u items %8lu us %7u bytes %4u blocks (%s)\n", label,
+               (unsigned)loaded.size(), (unsigned long)us,
+               (unsigned)(after.bytes - before.bytes), (unsigned)(after.blocks - before.blocks),
+               loaded.storageName());
+  }
+
+public:
+  static void print(Print& out) {
+    if (!LittleFS.begin(true)) {
+      out.println("LittleFS mount failed");
+      return;
+    }
+    std::vector<uint8_t> snapshot;
+
+    out.printf("Catalog load paths:\n");
+    {
+      HeapSample before = sample();
+      uint32_t start = micros();
+      Catalog parsed;
+      bool ok = ItemRepository::parseJSONFile("/catalogus.json", parsed);
+      uint32_t us = micros() - start;
+      printRow(out, "json", ok, us, parsed, before, sample());
+      if (ok) parsed.serialize(snapshot);
+    }
+
+    // Zelfde inhoud als binair bestand
+    bool written = false;
+    if (!snapshot.empty()) {
+      File file = LittleFS.open(TEMP_FILE, "w");
+      if (file) {
+        written = file.write(snapshot.data(), snapshot.size()) == snapshot.size();
+        file.close();
+      }
+    }
+    {
+      HeapSample before = sample();
+      uint32_t start = micros();
+      Catalog loaded;
+      bool ok = written && DatabaseService::getInstance().loadSnapshotFile(loaded, TEMP_FILE);
+      uint32_t us = micros() - start;
+      printRow(out, "bin file", ok, us, loaded, before, sample());
+    }
+    LittleFS.remove(TEMP_FILE);
+
+    {
+      // Alleen attach + controle (buffer al in RAM, telt niet mee)
+      Catalog loaded;
+      uint32_t start = micros();
+      bool ok = !snapshot.empty() && loaded.attach(snapshot.data(), snapshot.size());
+      uint32_t us = micros() - start;
+      HeapSample now = sample();
+      printRow(out, "bin ram", ok, us, loaded, now, now);
+    }
+
+    {
+      size_t size = 0;
+      const uint8_t* data = ItemRepository::mapCatalogPartition(size);
+      HeapSample before = sample();
+      uint32_t start = micros();
+      Catalog mapped;
+      bool ok = data && mapped.attach(data, size);
+      uint32_t us = micros() - start;
+      printRow(out, "partition", ok, us, mapped, before, sample());
+    }
+#ifdef HAS_BUILTIN_CATALOG
+    {
+      HeapSample before = sample();
+      uint32_t start = micros();
+      Catalog builtin;
+      bool ok = builtin.attach(CATALOG_BUILTIN, sizeof(CATALOG_BUILTIN));
+      uint32_t us = micros() - start;
+      printRow(out, "builtin", ok, us, builtin, before, sample());
+    }
+#endif
+    out.printf("  snapshot size %u bytes\n", (unsigned)snapshot.size());
+  }
+};
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef CATALOG_MEMORY_REPORT_H
+#define CATALOG_MEMORY_REPORT_H
+
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <vector>
+#include "../models/Catalog.h"
+
+// Vergelijkt de compacte catalogus (POD + arena) met de oude opslag
+// (een Item met twee Arduino Strings per record). Meet heap bytes en
+// blokken via heap_caps_get_info, dus inclusief allocator overhead.
+class CatalogMemoryReport {
+private:
+  // Oude layout, alleen voor de vergelijking
+  struct LegacyItem {
+    int id;
+    String name;
+    ItemCategory category;
+    uint16_t color;
+    bool canBeDirty;
+    int ledIndex;
+    String description;
+  };
+
+  struct HeapSample {
+    size_t bytes;
+    size_t blocks;
+  };
+
+  static HeapSample sample() {
+    multi_heap_info_t info;
+    heap_caps_get_info(&info, MALLOC_CAP_8BIT);
+    return {info.total_allocated_bytes, info.allocated_blocks};
+  }
+
+  static void printRow(Print& out, const char* label, size_t count,
+                       const HeapSample& before, const HeapSample& after) {
+    size_t bytes = after.bytes - before.bytes;
+    out.printf("  %-8s %5u items: %7u bytes %5u blocks (%u B/item)\n", label,
+               (unsigned)count, (unsigned)bytes, (unsigned)(after.blocks - before.blocks),
+               (unsigned)(count ? bytes / count : 0));
+  }
+
+  // Meet dezelfde inhoud in beide layouts
+  static void compare(Print& out, const Catalog& source) {
+    HeapSample before = sample();
+    {
+      Catalog compact;
+      compact.reserve(source.size());
+      for (const auto& item : source.all()) {
+        compact.add(item.id, source.nameOf(item), source.descriptionOf(item),
+                    item.category, item.color, item.canBeDirty);
+      }
+      compact.finalize();
+      printRow(out, "compact", compact.size(), before, sample());
+      out.printf("           records=%u strings=%u indexes=%u dedup saved=%u\n",
+                 (unsigned)compact.itemBytes(), (unsigned)compact.stringBytes(),
+                 (unsigned)compact.indexBytes(), (unsigned)compact.internedBytesSaved());
+    }
+
+    before = sample();
+    {
+      std::vector<LegacyItem> legacy;
+      legacy.reserve(source.size());
+      for (const auto& item : source.all()) {
+        LegacyItem l;
+        l.id = item.id;
+        l.name = source.nameOf(item);
+        l.description = source.descriptionOf(item);
+        l.category = item.category;
+        l.color = item.color;
+        l.canBeDirty = item.canBeDirty;
+        l.ledIndex = legacy.size();
+        legacy.push_back(l);
+      }
+      printRow(out, "legacy", legacy.size(), before, sample());
+    }
+  }
+
+public:
+  // Rapport voor de live catalogus en (optioneel) een synthetische
+  // catalogus van syntheticCount items met herhaalde omschrijvingen
+  static void print(Print& out, const Catalog& live, int syntheticCount) {
+    out.printf("Catalog in use: %u items, %u bytes (%s, %u on heap)\n",
+               (unsigned)live.size(), (unsigned)live.memoryUsage(),
+               live.storageName(), (unsigned)live.heapBytes());
+    const TrigramIndex& fuzzy = live.getTrigramIndex();
+    out.printf("Fuzzy index: %u trigrams, %u postings, %u/%u bytes, list cap %u, dropped %u\n",
+               (unsigned)fuzzy.trigramCount(), (unsigned)fuzzy.postingCount(),
+               (unsigned)fuzzy.memoryUsage(), (unsigned)FUZZY_INDEX_BUDGET,
+               (unsigned)fuzzy.getListCap(), (unsigned)fuzzy.getDroppedTrigrams());
+    compare(out, live);
+
+    if (syntheticCount <= 0) return;
+
+    static const char* descriptions[] = {
+      "Leeg en gespoeld", "Onbeschadigd papier", "Biologisch afval", "Restafval", ""
+    };
+    Catalog synthetic;
+    synthetic.reserve(syntheticCount);
+    char name[32];
+    for (int i = 0; i < syntheticCount; i++) {
+      snprintf(name, sizeof(name), "Synthetisch item %04d", i);
+      synthetic.add(i + 1, name, descriptions[i % 5], (ItemCategory)(i % 4), 0x6B4D, i % 3 == 0);
+    }
+    synthetic.finalize();
+
+    out.printf("Synthetic catalog:\n");
+    compare(out, synthetic);
+  }
+};
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef CATALOG_PAGING_REPORT_H
+#define CATALOG_PAGING_REPORT_H
+
+#include <Arduino.h>
+#include "FlashBlockModel.h"
+#include "../models/Catalog.h"
+#include "../models/ItemSearch.h"
+#include "../display/DisplayManager.h"
+
+// Toegang tot de live catalogus zoals de schermen die doen: grid pagina's
+// bladeren, A-Z sprongen, sleep rotatie en zoeken. Per stap de tijd (bij
+// een catalogus in flash inclusief cache misses) en, via FlashBlockModel,
+// hoeveel blokken een pager met een kleine LRU zou moeten inladen.
+// Test catalogus: tools/catalog_pack.py --synthetic 5000 in de partitie.
+class CatalogPagingReport {
+private:
+  struct StepStats {
+    uint32_t steps = 0;
+    uint32_t totalUs = 0;
+    uint32_t maxUs = 0;
+    uint32_t maxPageIns = 0;
+  };
+
+  // Wat een grid cel of het sleep scherm leest: record + naam
+  static uint32_t readItems(const Catalog& catalog, size_t first, size_t count,
+                            FlashBlockModel& model) {
+    uint32_t sum = 0;
+    for (size_t slot = first; slot < first + count && slot < (size_t)catalog.size(); slot++) {
+      const Item& item = catalog[slot];
+      const char* name = catalog.nameOf(item);
+      size_t length = strlen(name);
+      model.touch(&item, sizeof(Item));
+      model.touch(name, length + 1);
+      sum += length + item.color;
+    }
+    return sum;
+  }
+
+  template <typename F>
+  static void step(StepStats& stats, FlashBlockModel& model, F work) {
+    uint32_t before = model.pageInCount();
+    uint32_t start = micros();
+    work();
+    uint32_t us = micros() - start;
+    uint32_t pageIns = model.pageInCount() - before;
+    stats.steps++;
+    stats.totalUs += us;
+    if (us > stats.maxUs) stats.maxUs = us;
+    if (pageIns > stats.maxPageIns) stats.maxPageIns = pageIns;
+  }
+
+  static void printRow(Print& out, const char* label, const StepStats& stats,
+                       const FlashBlockModel& model) {
+    out.printf("  %-9s %5u steps %6lu us avg %6lu us max %6u page-ins (max %u/step) %5.1f%% hit\n",
+               label, (unsigned)stats.steps,
+               (unsigned long)(stats.steps ? stats.totalUs / stats.steps : 0),
+               (unsigned long)stats.maxUs, (unsigned)model.pageInCount(),
+               (unsigned)stats.maxPageIns, model.hitRate());
+  }
+
+public:
+  static void print(Print& out, const Catalog& catalog) {
+    const size_t n = catalog.size();
+    out.printf("Catalog paging: %u items (%s), %u bytes data, %u bytes heap\n",
+               (unsigned)n, catalog.storageName(), (unsigned)catalog.memoryUsage(),
+               (unsigned)catalog.heapBytes());
+    if (n == 0) return;
+
+    FlashBlockModel model;
+    out.printf("  model: LRU of %u x %u byte blocks\n",
+               (unsigned)model.blockCount(), (unsigned)model.blockSize());
+    volatile uint32_t sink = 0;
+
+    // Alle grid pagina's vooruit
+    StepStats grid;
+    for (size_t first = 0; first < n; first += ITEMS_PER_PAGE) {
+      step(grid, model, [&]() { sink += readItems(catalog, first, ITEMS_PER_PAGE, model); });
+    }
+    printRow(out, "grid", grid, model);
+
+    // A-Z paneel: sprong naar de eerste pagina van elke letter
+    model.reset();
+    StepStats letters;
+    for (char letter = 'A'; letter <= 'Z'; letter++) {
+      ItemSpan span = catalog.byLetter(letter);
+      if (span.empty()) continue;
+      size_t first = span.begin() - catalog.all().begin();
+      step(letters, model, [&]() { sink += readItems(catalog, first, ITEMS_PER_PAGE, model); });
+    }
+    printRow(out, "letters", letters, model);
+
+    // Sleep rotatie: één item per stap, de hele catalogus rond
+    model.reset();
+    StepStats rotation;
+    for (size_t slot = 0; slot < n; slot++) {
+      step(rotation, model, [&]() { sink += readItems(catalog, slot, 1, model); });
+    }
+    printRow(out, "rotation", rotation, model);
+
+    // Zoeken (index gebruik zit niet in het model, alleen de tijd)
+    static const char* queries[] = {"f", "fl", "fles", "karton", "verpakkng", "zzz"};
+    ItemSearch search;
+    StepStats searches;
+    model.reset();
+    for (const char* query : queries) {
+      step(searches, model, [&]() {
+        size_t hits = search.run(catalog, query);
+        for (size_t i = 0; i < hits && i < ITEMS_PER_PAGE; i++) {
+          sink += readItems(catalog, search.slotAt(i), 1, model);
+        }
+      });
+    }
+    printRow(out, "search", searches, model);
+  }
+};
+
+#endif
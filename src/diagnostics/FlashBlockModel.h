@@ -0,0 +1,65 @@
+#ifndef FLASH_BLOCK_MODEL_H
+#define FLASH_BLOCK_MODEL_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Model van een blok cache voor een catalogus in flash: vaste blokken
+// (standaard 4 KB) in een kleine LRU (standaard 8 = 32 KB, de grootte
+// van de ESP32 flash cache). touch() per gelezen stuk geheugen; hits en
+// page-ins tellen wat een echte pager zou doen. Geen heap, geen Arduino
+// (ook bruikbaar in tools/bench).
+class FlashBlockModel {
+public:
+  static const size_t MAX_BLOCKS = 32;
+
+private:
+  uint32_t blocks[MAX_BLOCKS];   // Index 0 = meest recent gebruikt
+  size_t used = 0;
+  size_t capacity;
+  uint8_t shift;
+  uint32_t hitCount = 0;
+  uint32_t pageIns = 0;
+
+  void touchBlock(uint32_t block) {
+    size_t i = 0;
+    while (i < used && blocks[i] != block) i++;
+    if (i < used) {
+      hitCount++;
+    } else {
+      pageIns++;
+      if (used < capacity) used++;
+      i = used - 1;  // Vol: de minst recente valt eruit
+    }
+    for (; i > 0; i--) blocks[i] = blocks[i - 1];
+    blocks[0] = block;
+  }
+
+public:
+  explicit FlashBlockModel(size_t blockCount = 8, uint8_t blockShift = 12)
+    : capacity(blockCount < MAX_BLOCKS ? blockCount : MAX_BLOCKS), shift(blockShift) {}
+
+  void touch(const void* data, size_t length) {
+    uintptr_t first = reinterpret_cast<uintptr_t>(data) >> shift;
+    uintptr_t last = (reinterpret_cast<uintptr_t>(data) + (length ? length - 1 : 0)) >> shift;
+    for (uintptr_t b = first; b <= last; b++) touchBlock((uint32_t)b);
+  }
+
+  void reset() {
+    used = 0;
+    hitCount = 0;
+    pageIns = 0;
+  }
+
+  uint32_t hits() const { return hitCount; }
+  uint32_t pageInCount() const { return pageIns; }
+  uint32_t accesses() const { return hitCount + pageIns; }
+  float hitRate() const { return accesses() ? 100.0f * hitCount / accesses() : 0.0f; }
+  size_t blockSize() const { return (size_t)1 << shift; }
+  // Geschatte tijd voor één page-in: QIO flash op 40 MHz leest ~20 MB/s
+  // (4 bits per klok), plus ~10 us voor het lees commando
+  uint32_t blockLoadUs() const { return 10 + (uint32_t)(blockSize() / 20); }
+  size_t blockCount() const { return capacity; }
+};
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef HEAP_WATERMARK_H
+#define HEAP_WATERMARK_H
+
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+
+// Laagste vrije heap tijdens een stuk werk (bijv. een fetch). sample() op
+// de momenten dat er het meest in gebruik is; peakUsed() is dan het
+// maximum extra geheugen ten opzichte van het begin.
+class HeapWatermark {
+private:
+  size_t startFree;
+  size_t lowest;
+
+public:
+  HeapWatermark() {
+    startFree = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    lowest = startFree;
+  }
+
+  void sample() {
+    size_t free = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    if (free < lowest) lowest = free;
+  }
+
+  size_t peakUsed() const { return startFree - lowest; }
+  size_t minFree() const { return lowest; }
+
+  // Past een blok van bytes nog, met reserve voor de rest van de firmware?
+  static bool fits(size_t bytes, size_t reserve) {
+    return bytes + reserve <= heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+  }
+};
+
+#endif
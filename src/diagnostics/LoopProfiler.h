@@ -0,0 +1,135 @@
+#ifndef LOOP_PROFILER_H
+#define LOOP_PROFILER_H
+
+#include <Arduino.h>
+#include "../config.h"
+
+// Cycle-accurate timing per main-loop stage (= scheduler taak) plus idle.
+// Duur wordt in CPU cycles gemeten (ESP.getCycleCount) en in een
+// log-schaal histogram bijgehouden voor de p99.
+struct StageStats {
+  const char* name;
+  uint32_t count;
+  uint32_t minCycles;
+  uint32_t maxCycles;
+  uint64_t totalCycles;
+  // Bucket = 4 * log2(cycles) + 2 mantisse bits: 4 buckets per octaaf,
+  // elk 25% van het begin van het octaaf breed. p99 is de bovengrens van
+  // zijn bucket: hooguit 25% te hoog, nooit te laag.
+  uint32_t histogram[PROFILER_BUCKETS];
+};
+
+class LoopProfiler {
+private:
+  StageStats stages[PROFILER_MAX_STAGES];
+  int stageCount = 0;
+  uint32_t cpuMHz = 240;
+  unsigned long windowStart = 0;
+
+  static int bucketFor(uint32_t cycles) {
+    if (cycles < 4) return cycles;
+    int msb = 31 - __builtin_clz(cycles);
+    int mantissa = (cycles >> (msb - 2)) & 0x3;
+    int bucket = msb * 4 + mantissa - 4;
+    return bucket < PROFILER_BUCKETS ? bucket : PROFILER_BUCKETS - 1;
+  }
+
+  // Bovengrens van een bucket in cycles (conservatief voor p99)
+  static uint32_t bucketUpperBound(int bucket) {
+    if (bucket < 4) return bucket;
+    int msb = (bucket + 4) / 4;
+    int mantissa = (bucket + 4) % 4;
+    if (msb >= 31) return UINT32_MAX;
+    return ((uint32_t)(4 + mantissa + 1) << (msb - 2)) - 1;
+  }
+
+  uint32_t percentile(const StageStats& s, float p) const {
+    if (s.count == 0) return 0;
+    uint32_t target = (uint32_t)(s.count * p);
+    uint32_t seen = 0;
+    for (int i = 0; i < PROFILER_BUCKETS; i++) {
+      seen += s.histogram[i];
+      if (seen > target) {
+        uint32_t bound = bucketUpperBound(i);
+        return bound < s.maxCycles ? bound : s.maxCycles;
+      }
+    }
+    return s.maxCycles;
+  }
+
+  float toUs(uint32_t cycles) const {
+    return (float)cycles / cpuMHz;
+  }
+
+  LoopProfiler() {}
+
+public:
+  static LoopProfiler& getInstance() {
+    static LoopProfiler instance;
+    return instance;
+  }
+
+  LoopProfiler(const LoopProfiler&) = delete;
+  void operator=(const LoopProfiler&) = delete;
+
+  int addStage(const char* name) {
+    if (stageCount >= PROFILER_MAX_STAGES) {
+      Serial.printf("LoopProfiler: no room for stage '%s' (PROFILER_MAX_STAGES=%d)\n",
+                    name, PROFILER_MAX_STAGES);
+      return -1;
+    }
+    cpuMHz = ESP.getCpuFreqMHz();
+    StageStats& s = stages[stageCount];
+    memset(&s, 0, sizeof(s));
+    s.name = name;
+    s.minCycles = UINT32_MAX;
+    return stageCount++;
+  }
+
+  static inline uint32_t now() {
+    return ESP.getCycleCount();
+  }
+
+  inline void record(int stage, uint32_t cycles) {
+    if (stage < 0 || stage >= stageCount) return;
+    StageStats& s = stages[stage];
+    s.count++;
+    s.totalCycles += cycles;
+    if (cycles < s.minCycles) s.minCycles = cycles;
+    if (cycles > s.maxCycles) s.maxCycles = cycles;
+    s.histogram[bucketFor(cycles)]++;
+  }
+
+  void reset() {
+    for (int i = 0; i < stageCount; i++) {
+      const char* name = stages[i].name;
+      memset(&stages[i], 0, sizeof(StageStats));
+      stages[i].name = name;
+      stages[i].minCycles = UINT32_MAX;
+    }
+    windowStart = millis();
+  }
+
+  void printStats(Print& out) const {
+    unsigned long windowMs = millis() - windowStart;
+    uint64_t windowCycles = (uint64_t)windowMs * 1000 * cpuMHz;
+
+    out.printf("Loop profile over %lu ms @ %u MHz (us)\n", windowMs, cpuMHz);
+    out.printf("%-10s %8s %9s %9s %9s %9s %6s\n",
+               "stage", "count", "min", "avg", "p99", "max", "load");
+    for (int i = 0; i < stageCount; i++) {
+      const StageStats& s = stages[i];
+      if (s.count == 0) {
+        out.printf("%-10s %8u %9s %9s %9s %9s %6s\n", s.name, 0u, "-", "-", "-", "-", "-");
+        continue;
+      }
+      uint32_t avg = (uint32_t)(s.totalCycles / s.count);
+      float load = windowCycles ? 100.0f * s.totalCycles / windowCycles : 0.0f;
+      out.printf("%-10s %8u %9.1f %9.1f %9.1f %9.1f %5.1f%%\n",
+                 s.name, s.count, toUs(s.minCycles), toUs(avg),
+                 toUs(percentile(s, 0.99f)), toUs(s.maxCycles), load);
+    }
+  }
+};
+
+#endif
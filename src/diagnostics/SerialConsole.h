@@ -0,0 +1,83 @@
+#ifndef SERIAL_CONSOLE_H
+#define SERIAL_CONSOLE_H
+
+#include <Arduino.h>
+#include <functional>
+#include <vector>
+
+// Regel-gebaseerde diagnose console over Serial.
+// Leest non-blocking; een commando wordt uitgevoerd bij '\n'.
+using ConsoleHandler = std::function<void(const char* args)>;
+
+struct ConsoleCommand {
+  const char* name;
+  const char* help;
+  ConsoleHandler handler;
+};
+
+class SerialConsole {
+private:
+  static const size_t LINE_MAX = 64;
+
+  std::vector<ConsoleCommand> commands;
+  char line[LINE_MAX];
+  size_t lineLength = 0;
+
+  SerialConsole() {
+    registerCommand("help", "Toon alle commando's", [this](const char*) {
+      for (const auto& cmd : commands) {
+        Serial.printf("  %-10s %s\n", cmd.name, cmd.help);
+      }
+    });
+  }
+
+  void execute() {
+    line[lineLength] = '\0';
+
+    // Split "naam args"
+    char* args = line;
+    while (*args && *args != ' ') args++;
+    if (*args) {
+      *args++ = '\0';
+      while (*args == ' ') args++;
+    }
+
+    if (line[0] == '\0') return;
+
+    for (const auto& cmd : commands) {
+      if (strcmp(cmd.name, line) == 0) {
+        cmd.handler(args);
+        return;
+      }
+    }
+    Serial.printf("Unknown command: %s (try 'help')\n", line);
+  }
+
+public:
+  static SerialConsole& getInstance() {
+    static SerialConsole instance;
+    return instance;
+  }
+
+  SerialConsole(const SerialConsole&) = delete;
+  void operator=(const SerialConsole&) = delete;
+
+  void registerCommand(const char* name, const char* help, ConsoleHandler handler) {
+    commands.push_back({name, help, handler});
+  }
+
+  void update() {
+    while (Serial.available() > 0) {
+      char c = (char)Serial.read();
+      if (c == '\r') continue;
+      if (c == '\n') {
+        execute();
+        lineLength = 0;
+      } else if (lineLength < LINE_MAX - 1) {
+        line[lineLength++] = c;
+      }
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,170 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <Arduino.h>
+#include "../config.h"
+
+// Static trace names - de index is het name ID dat in de ring buffer komt.
+// EVENT_* moet in dezelfde volgorde blijven als EventType (zie Event.h).
+enum class TraceName : uint8_t {
+  SCHEDULER_IDLE,
+  APP_RENDER,
+  TOUCH_UPDATE,
+  SLEEP_UPDATE,
+  LED_UPDATE,
+  STATE_UPDATE,
+  APP_INIT,
+  DB_FETCH_ITEMS,
+  DB_POST_SELECTION,
+  DB_CHECK_STATUS,
+  DB_PROCESS_PENDING,
+  DB_SAVE_CACHE,
+  DB_LOAD_CACHE,
+  DB_QUEUE_POST,
+  REPO_LOAD_JSON,
+  REPO_LOAD_PARTITION,
+  EVENT_TOUCH_PRESSED,
+  EVENT_SWIPE_LEFT,
+  EVENT_SWIPE_RIGHT,
+  EVENT_ITEM_SELECTED,
+  EVENT_CATEGORY_CHANGED,
+  EVENT_LED_ANIMATION_DONE,
+  EVENT_SCREEN_CHANGED,
+  EVENT_WIFI_CONNECTED,
+  EVENT_WIFI_DISCONNECTED,
+  EVENT_DATA_RECEIVED,
+  EVENT_NETWORK_RESULT,
+  COUNT
+};
+
+enum class TracePhase : uint8_t {
+  BEGIN = 'B',
+  END = 'E',
+  INSTANT = 'i'
+};
+
+// 8 bytes per record
+struct TraceRecord {
+  uint32_t timestampUs;
+  uint8_t nameId;
+  uint8_t phase;
+  uint8_t core;
+  uint8_t reserved;
+};
+
+class Tracer {
+private:
+  TraceRecord records[TRACE_BUFFER_SIZE];
+  uint32_t head = 0;        // Volgende schrijfpositie (loopt door, modulo bij gebruik)
+  uint32_t dropped = 0;     // Overschreven records sinds laatste clear
+  bool enabled = true;
+  portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+
+  Tracer() {}
+
+public:
+  static Tracer& getInstance() {
+    static Tracer instance;
+    return instance;
+  }
+
+  Tracer(const Tracer&) = delete;
+  void operator=(const Tracer&) = delete;
+
+  static const char* nameToString(uint8_t id) {
+    static const char* const names[] = {
+      "Scheduler::idle", "App::render", "Touch::update", "Sleep::update",
+      "LED::update", "State::update",
+      "App::init", "DB::fetchItems", "DB::postItemSelection",
+      "DB::checkApiStatus", "DB::processPendingPosts", "DB::saveCache",
+      "DB::loadCache", "DB::queuePost", "Repo::loadFromJSON",
+      "Repo::loadFromPartition",
+      "ev:TOUCH_PRESSED", "ev:SWIPE_LEFT", "ev:SWIPE_RIGHT",
+      "ev:ITEM_SELECTED", "ev:CATEGORY_CHANGED", "ev:LED_ANIMATION_DONE",
+      "ev:SCREEN_CHANGED", "ev:WIFI_CONNECTED", "ev:WIFI_DISCONNECTED",
+      "ev:DATA_RECEIVED", "ev:NETWORK_RESULT"
+    };
+    static_assert(sizeof(names) / sizeof(names[0]) == (size_t)TraceName::COUNT,
+                  "Trace name table out of sync with TraceName");
+    return id < (uint8_t)TraceName::COUNT ? names[id] : "?";
+  }
+
+  inline void record(uint8_t nameId, TracePhase phase) {
+    if (!enabled) return;
+    uint32_t now = micros();
+    portENTER_CRITICAL(&lock);
+    TraceRecord& r = records[head % TRACE_BUFFER_SIZE];
+    r.timestampUs = now;
+    r.nameId = nameId;
+    r.phase = (uint8_t)phase;
+    r.core = (uint8_t)xPortGetCoreID();
+    if (head >= TRACE_BUFFER_SIZE) dropped++;
+    head++;
+    portEXIT_CRITICAL(&lock);
+  }
+
+  void setEnabled(bool on) { enabled = on; }
+  bool isEnabled() const { return enabled; }
+
+  void clear() {
+    portENTER_CRITICAL(&lock);
+    head = 0;
+    dropped = 0;
+    portEXIT_CRITICAL(&lock);
+  }
+
+  // Dump als tekst, oudste record eerst. tools/trace2chrome.py zet dit om
+  // naar Chrome trace_event JSON (Perfetto / chrome://tracing).
+  void dump(Print& out) {
+    bool wasEnabled = enabled;
+    enabled = false;  // Buffer niet aanpassen tijdens het dumpen
+
+    uint32_t count = head < TRACE_BUFFER_SIZE ? head : TRACE_BUFFER_SIZE;
+    uint32_t start = head - count;
+
+    out.printf("# TRACE BEGIN count=%u dropped=%u\n", count, dropped);
+    for (uint32_t i = start; i < head; i++) {
+      const TraceRecord& r = records[i % TRACE_BUFFER_SIZE];
+      out.printf("%u %c %u %s\n", r.timestampUs, (char)r.phase, r.core,
+                 nameToString(r.nameId));
+    }
+    out.println("# TRACE END");
+
+    enabled = wasEnabled;
+  }
+
+  uint32_t getRecordCount() const {
+    return head < TRACE_BUFFER_SIZE ? head : TRACE_BUFFER_SIZE;
+  }
+  uint32_t getDroppedCount() const { return dropped; }
+};
+
+// Scoped span: BEGIN in constructor, END in destructor
+class TraceScope {
+private:
+  uint8_t nameId;
+
+public:
+  explicit TraceScope(TraceName name) : nameId((uint8_t)name) {
+    Tracer::getInstance().record(nameId, TracePhase::BEGIN);
+  }
+  explicit TraceScope(uint8_t id) : nameId(id) {
+    Tracer::getInstance().record(nameId, TracePhase::BEGIN);
+  }
+  ~TraceScope() {
+    Tracer::getInstance().record(nameId, TracePhase::END);
+  }
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#if TRACE_ENABLED
+  #define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(_traceScope, __LINE__)(name)
+  #define TRACE_INSTANT(name) Tracer::getInstance().record((uint8_t)(name), TracePhase::INSTANT)
+#else
+  #define TRACE_SCOPE(name) do {} while (0)
+  #define TRACE_INSTANT(name) do {} while (0)
+#endif
+
+#endif
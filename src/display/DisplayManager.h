@@ -5,12 +5,35 @@
 #include <vector>
 #include "../config.h"
 #include "../models/Item.h"
+#include "../models/ItemView.h"
+#include "../models/Catalog.h"
 
 // Layout constants - 2x2 grid, full width
 #define GRID_ITEM_COLS 2
 #define GRID_ITEM_ROWS 2
 #define ITEMS_PER_PAGE (GRID_ITEM_COLS * GRID_ITEM_ROWS)
 
+// Letter paneel (A-Z + '#') in het content gebied
+#define LETTER_PANEL_COLS 6
+#define LETTER_PANEL_ROWS 5
+
+// Footer: middelste knop opent het letter paneel
+#define FOOTER_BUTTON_WIDTH 70
+#define FOOTER_INDEX_X_MIN 80
+#define FOOTER_INDEX_X_MAX 160
+
+// Zoek scherm: query in de header, 2x2 treffers, toetsenbord eronder
+#define SEARCH_RESULT_COLS 2
+#define SEARCH_RESULT_ROWS 2
+#define SEARCH_RESULT_CELLS (SEARCH_RESULT_COLS * SEARCH_RESULT_ROWS)
+#define SEARCH_CELL_HEIGHT 60
+#define SEARCH_CLOSE_WIDTH 40
+#define KEYBOARD_Y (HEADER_HEIGHT + SEARCH_RESULT_ROWS * SEARCH_CELL_HEIGHT)  // 160
+#define KEYBOARD_COLS 7
+#define KEYBOARD_ROWS 4
+#define KEY_HEIGHT ((PORTRAIT_HEIGHT - KEYBOARD_Y) / KEYBOARD_ROWS)        // 40
+#define KEYBOARD_LAYOUT "ABCDEFGHIJKLMNOPQRSTUVWXYZ \b"                    // 28 toetsen
+
 class DisplayManager {
 private:
   TFT_eSPI* tft;
@@ -70,30 +93,134 @@ public:
   }
 
   // ========== ITEM GRID (2x2, full width) ==========
-  void drawItemGrid(const std::vector<Item>& items, int scrollOffset = 0) {
+  void drawItemGrid(const Catalog& catalog, ItemSpan items, int scrollOffset = 0) {
+    clearGridArea();
+    for (int i = 0; i < ITEMS_PER_PAGE && (scrollOffset + i) < items.size(); i++) {
+      const Item& item = items[scrollOffset + i];
+      drawGridCell(i, item, catalog.nameOf(item));
+    }
+  }
+
+  // Losse items (bijv. de "Vaak gekozen" pagina): de eerste ITEMS_PER_PAGE
+  void drawItemGrid(const Catalog& catalog, const IndexedItemRange& items) {
+    clearGridArea();
+    for (int i = 0; i < ITEMS_PER_PAGE && i < (int)items.size(); i++) {
+      drawGridCell(i, items[i], catalog.nameOf(items[i]));
+    }
+  }
+
+  // ========== LETTER PANEL (snel springen naar een letter) ==========
+  // Tekent alleen het content gebied; letters zonder items zijn gedimd
+  void drawLetterPanel(const Catalog& catalog, int activeBucket) {
     int contentHeight = PORTRAIT_HEIGHT - HEADER_HEIGHT - FOOTER_HEIGHT;
-    int itemWidth = PORTRAIT_WIDTH / GRID_ITEM_COLS;   // 120px each
-    int itemHeight = contentHeight / GRID_ITEM_ROWS;   // ~125px each
-    int startY = HEADER_HEIGHT;
+    int cellW = PORTRAIT_WIDTH / LETTER_PANEL_COLS;    // 40px
+    int cellH = contentHeight / LETTER_PANEL_ROWS;     // 46px
 
-    // Clear content area
-    tft->fillRect(0, startY, PORTRAIT_WIDTH, contentHeight, COLOR_BG);
+    tft->fillRect(0, HEADER_HEIGHT, PORTRAIT_WIDTH, contentHeight, COLOR_SIDEBAR);
+    tft->setTextDatum(MC_DATUM);
 
-    for (int i = 0; i < ITEMS_PER_PAGE && (scrollOffset + i) < items.size(); i++) {
-      int idx = scrollOffset + i;
-      const Item& item = items[idx];
-      
-      int col = i % GRID_ITEM_COLS;
-      int row = i / GRID_ITEM_COLS;
-      int x = col * itemWidth;
-      int y = startY + row * itemHeight;
+    for (int b = 0; b < Catalog::LETTER_BUCKETS; b++) {
+      int x = (b % LETTER_PANEL_COLS) * cellW;
+      int y = HEADER_HEIGHT + (b / LETTER_PANEL_COLS) * cellH;
+      bool available = catalog.letterCount(b) > 0;
+      char label[2] = { b < 26 ? (char)('A' + b) : '#', '\0' };
+
+      if (b == activeBucket) {
+        tft->drawRoundRect(x + 2, y + 2, cellW - 4, cellH - 4, 6, COLOR_SELECTED);
+      }
+      tft->setTextColor(available ? COLOR_TEXT : COLOR_TEXT_DIM, COLOR_SIDEBAR);
+      tft->drawString(label, x + cellW / 2, y + cellH / 2, 4);
+    }
+    tft->setTextDatum(TL_DATUM);
+  }
+
+  // ========== ZOEKEN ==========
+  // fuzzy: treffers komen uit de tikfout-tolerante zoektocht ("~")
+  void drawSearchHeader(const char* query, size_t first, size_t total, bool fuzzy) {
+    tft->fillRect(0, 0, PORTRAIT_WIDTH, HEADER_HEIGHT, COLOR_HEADER);
+    tft->setTextColor(TFT_WHITE, COLOR_HEADER);
+    tft->setTextDatum(ML_DATUM);
+    String text = String("Zoek: ") + query + "_";
+    tft->drawString(text.c_str(), 5, HEADER_HEIGHT / 2, 2);
+
+    // Aantal treffers en sluit knop rechts
+    tft->setTextDatum(MR_DATUM);
+    if (total > 0) {
+      char countStr[16];
+      size_t last = first + SEARCH_RESULT_CELLS < total ? first + SEARCH_RESULT_CELLS : total;
+      snprintf(countStr, sizeof(countStr), "%s%u-%u/%u", fuzzy ? "~" : "",
+               (unsigned)first + 1, (unsigned)last, (unsigned)total);
+      tft->setTextColor(COLOR_TEXT_DIM, COLOR_HEADER);
+      tft->drawString(countStr, PORTRAIT_WIDTH - SEARCH_CLOSE_WIDTH - 4, HEADER_HEIGHT / 2, 1);
+    }
+    tft->fillRoundRect(PORTRAIT_WIDTH - SEARCH_CLOSE_WIDTH + 4, 4, SEARCH_CLOSE_WIDTH - 8,
+                       HEADER_HEIGHT - 8, 6, COLOR_ACCENT);
+    tft->setTextColor(TFT_WHITE, COLOR_ACCENT);
+    tft->setTextDatum(MC_DATUM);
+    tft->drawString("X", PORTRAIT_WIDTH - SEARCH_CLOSE_WIDTH / 2, HEADER_HEIGHT / 2, 2);
+    tft->setTextDatum(TL_DATUM);
+  }
+
+  // Eén treffer cel; item == nullptr maakt de cel leeg
+  void drawSearchResultCell(int cell, const Item* item, const char* itemName) {
+    int cellW = PORTRAIT_WIDTH / SEARCH_RESULT_COLS;
+    int x = (cell % SEARCH_RESULT_COLS) * cellW;
+    int y = HEADER_HEIGHT + (cell / SEARCH_RESULT_COLS) * SEARCH_CELL_HEIGHT;
+
+    tft->fillRect(x, y, cellW, SEARCH_CELL_HEIGHT, COLOR_BG);
+    if (!item) return;
+
+    tft->fillRoundRect(x + 3, y + 3, cellW - 6, SEARCH_CELL_HEIGHT - 6, 8, item->color);
+    tft->setTextColor(TFT_WHITE, item->color);
+    tft->setTextDatum(MC_DATUM);
 
-      drawItemBox(x, y, itemWidth, itemHeight, item);
+    String name = itemName;
+    if (name.length() <= 13) {
+      tft->drawString(name.c_str(), x + cellW / 2, y + SEARCH_CELL_HEIGHT / 2, 2);
+    } else {
+      if (name.length() > 19) name = name.substring(0, 17) + "..";
+      tft->drawString(name.c_str(), x + cellW / 2, y + SEARCH_CELL_HEIGHT / 2, 1);
     }
+    tft->setTextDatum(TL_DATUM);
+  }
+
+  void drawKeyboard() {
+    int keyW = PORTRAIT_WIDTH / KEYBOARD_COLS;  // 34px
+    const char* keys = KEYBOARD_LAYOUT;
+
+    tft->fillRect(0, KEYBOARD_Y, PORTRAIT_WIDTH, PORTRAIT_HEIGHT - KEYBOARD_Y, COLOR_SIDEBAR);
+    tft->setTextDatum(MC_DATUM);
+    for (int i = 0; keys[i]; i++) {
+      int x = (i % KEYBOARD_COLS) * keyW;
+      int y = KEYBOARD_Y + (i / KEYBOARD_COLS) * KEY_HEIGHT;
+      tft->fillRoundRect(x + 2, y + 2, keyW - 4, KEY_HEIGHT - 4, 5, COLOR_BG_LIGHT);
+      tft->setTextColor(TFT_WHITE, COLOR_BG_LIGHT);
+
+      char label[2] = { keys[i], '\0' };
+      if (keys[i] == ' ') label[0] = '_';
+      if (keys[i] == '\b') label[0] = '<';
+      tft->drawString(label, x + keyW / 2, y + KEY_HEIGHT / 2, 2);
+    }
+    tft->setTextDatum(TL_DATUM);
   }
 
   // ========== SINGLE ITEM BOX (groot vierkant) ==========
-  void drawItemBox(int x, int y, int width, int height, const Item& item) {
+  void clearGridArea() {
+    int contentHeight = PORTRAIT_HEIGHT - HEADER_HEIGHT - FOOTER_HEIGHT;
+    tft->fillRect(0, HEADER_HEIGHT, PORTRAIT_WIDTH, contentHeight, COLOR_BG);
+  }
+
+  // Cel i (0..ITEMS_PER_PAGE-1) van de 2x2 grid
+  void drawGridCell(int i, const Item& item, const char* name) {
+    int contentHeight = PORTRAIT_HEIGHT - HEADER_HEIGHT - FOOTER_HEIGHT;
+    int itemWidth = PORTRAIT_WIDTH / GRID_ITEM_COLS;   // 120px each
+    int itemHeight = contentHeight / GRID_ITEM_ROWS;   // ~125px each
+    int x = (i % GRID_ITEM_COLS) * itemWidth;
+    int y = HEADER_HEIGHT + (i / GRID_ITEM_COLS) * itemHeight;
+    drawItemBox(x, y, itemWidth, itemHeight, item, name);
+  }
+
+  void drawItemBox(int x, int y, int width, int height, const Item& item, const char* itemName) {
     int padding = 5;
     int boxX = x + padding;
     int boxY = y + padding;
@@ -111,7 +238,7 @@ public:
     tft->setTextColor(TFT_WHITE, item.color);
     tft->setTextDatum(MC_DATUM);
     
-    String name = item.name;
+    String name = itemName;
     int centerX = boxX + boxW/2;
     int centerY = boxY + boxH/2;
     
@@ -193,7 +320,7 @@ public:
   }
 
   // ========== DIRTY/CLEAN POPUP ==========
-  void drawDirtyCleanPopup(const Item& item) {
+  void drawDirtyCleanPopup(const Item& item, const char* itemName) {
     // Volledig scherm popup voor betere touch
     tft->fillScreen(COLOR_BG);
     
@@ -202,7 +329,7 @@ public:
     tft->setTextColor(TFT_WHITE, item.color);
     tft->setTextDatum(MC_DATUM);
     
-    String name = item.name;
+    String name = itemName;
     if (name.length() <= 10) {
       tft->drawString(name.c_str(), PORTRAIT_WIDTH / 2, 30, 4);
     } else if (name.length() <= 18) {
@@ -262,7 +389,7 @@ public:
   }
 
   // ========== RESULT SCREEN ==========
-  void drawResultScreen(const Item& item, bool isDirty) {
+  void drawResultScreen(const Item& item, const char* itemName, const char* description, bool isDirty) {
     tft->fillScreen(COLOR_BG);
     
     // Header with result - use proper Dutch names
@@ -284,7 +411,7 @@ public:
     tft->setTextDatum(MC_DATUM);
     
     // Handle long names in header
-    String name = item.name;
+    String name = itemName;
     if (name.length() <= 10) {
       // Short name - use large font
       tft->drawString(name.c_str(), PORTRAIT_WIDTH / 2, 30, 4);
@@ -351,7 +478,7 @@ public:
     
     // Description
     tft->setTextColor(COLOR_TEXT, COLOR_BG);
-    tft->drawString(item.description.c_str(), PORTRAIT_WIDTH / 2, iconY + iconSize + 30, 2);
+    tft->drawString(description, PORTRAIT_WIDTH / 2, iconY + iconSize + 30, 2);
     
     // Footer
     tft->fillRect(0, PORTRAIT_HEIGHT - FOOTER_HEIGHT, PORTRAIT_WIDTH, FOOTER_HEIGHT, COLOR_HEADER);
@@ -367,7 +494,7 @@ public:
     tft->fillRect(0, footerY, PORTRAIT_WIDTH, FOOTER_HEIGHT, COLOR_HEADER);
     
     if (totalPages > 1) {
-      int btnWidth = 70;
+      int btnWidth = FOOTER_BUTTON_WIDTH;
       int btnHeight = 40;
       int btnY = footerY + (FOOTER_HEIGHT - btnHeight) / 2;
       
@@ -377,12 +504,13 @@ public:
       tft->setTextDatum(MC_DATUM);
       tft->drawString("<", 40, btnY + btnHeight/2, 4);
       
-      // Pagina nummer in midden
-      char pageText[15];
-      sprintf(pageText, "%d / %d", currentPage, totalPages);
-      tft->setTextColor(TFT_WHITE, COLOR_HEADER);
+      // A-Z knop in midden (pagina nummer staat in de header)
+      int indexW = FOOTER_INDEX_X_MAX - FOOTER_INDEX_X_MIN;
+      tft->fillRoundRect(FOOTER_INDEX_X_MIN, btnY, indexW, btnHeight, 8, COLOR_SIDEBAR);
+      tft->drawRoundRect(FOOTER_INDEX_X_MIN, btnY, indexW, btnHeight, 8, COLOR_ACCENT);
+      tft->setTextColor(TFT_WHITE, COLOR_SIDEBAR);
       tft->setTextDatum(MC_DATUM);
-      tft->drawString(pageText, PORTRAIT_WIDTH / 2, footerY + FOOTER_HEIGHT / 2, 2);
+      tft->drawString("A-Z", PORTRAIT_WIDTH / 2, btnY + btnHeight/2, 2);
       
       // Volgende button (rechts) - altijd actief (wrap-around)
       tft->fillRoundRect(PORTRAIT_WIDTH - btnWidth - 5, btnY, btnWidth, btnHeight, 8, COLOR_ACCENT);
@@ -4,6 +4,7 @@
 #include <Arduino.h>
 #include <functional>
 #include <vector>
+#include "../diagnostics/Tracer.h"
 
 // Event types
 enum class EventType {
@@ -16,7 +17,8 @@ enum class EventType {
   SCREEN_CHANGED,
   WIFI_CONNECTED,
   WIFI_DISCONNECTED,
-  DATA_RECEIVED
+  DATA_RECEIVED,
+  NETWORK_RESULT
 };
 
 struct Event {
@@ -44,6 +46,7 @@ public:
   }
 
   void dispatch(const Event& event) {
+    TRACE_SCOPE((uint8_t)TraceName::EVENT_TOUCH_PRESSED + (uint8_t)event.type);
     for (const auto& listener : listeners) {
       if (listener.first == event.type) {
         listener.second(event);
@@ -5,6 +5,7 @@
 #include <FastLED.h>
 #include "config.h"
 #include "Application.h"
+#include "diagnostics/BootTimer.h"
 
 // Touch uses separate SPI with custom pins
 SPIClass touchSPI(VSPI);
@@ -20,15 +21,17 @@ CRGB ledsStrip4[NUM_LEDS_PER_STRIP];  // Waste/Rest
 std::unique_ptr<Application> app;
 
 void setup() {
+  BootTimer& boot = BootTimer::getInstance();
+  boot.mark("setup");
+
   Serial.begin(115200);
-  delay(1000);
-  
   Serial.println("\n\nStarting Recyclebin ESP32...");
 
   // Initialize TFT FIRST (it uses HSPI)
   tft.init();
   tft.setRotation(0);  // Portrait mode
   Serial.println("TFT initialized");
+  boot.mark("tft");
 
   // Configure touch CS pin
   pinMode(XPT2046_CS, OUTPUT);
@@ -57,6 +60,7 @@ void setup() {
   FastLED.addLeds<APA102, LED4_DATA_PIN, LED4_CLK_PIN, BGR>(ledsStrip4, NUM_LEDS_PER_STRIP);
   
   Serial.println("4 LED strips initialized");
+  boot.mark("touch+leds");
 
   // Application - pass all 4 strip arrays
   app = std::make_unique<Application>(&tft, &touchscreen, 
@@ -66,7 +70,5 @@ void setup() {
 }
 
 void loop() {
-  app->update();
-  app->render();
-  delay(16);
+  app->run();  // Scheduler slaapt zelf tot de volgende taak due is
 }
\ No newline at end of file
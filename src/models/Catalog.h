@@ -0,0 +1,569 @@
+#ifndef CATALOG_H
+#define CATALOG_H
+
+#include "Item.h"
+#include "ItemView.h"
+#include "StringArena.h"
+#include "TextFold.h"
+#include "TrigramIndex.h"
+#include "CatalogFormat.h"
+#include "../config.h"
+#include <vector>
+#include <algorithm>
+
+// Eén catalogus snapshot: POD items + string arena + indexen, read-only
+// zodra hij klaar is. Twee manieren om er een te maken:
+//  - bouwen: add... -> finalize() sorteert en bouwt de indexen
+//  - binair snapshot (zie CatalogFormat): attach() leest in place, bijv.
+//    uit gemapte flash, of loadSnapshot() neemt een RAM buffer over
+// Lookups lopen via pointers (Array), dus beide vormen werken hetzelfde.
+class Catalog {
+public:
+  static const uint8_t LETTER_BUCKETS = CatalogFormat::LETTER_BUCKETS;  // A-Z + overig
+  static const size_t MAX_ITEMS = 65535;     // Slots zijn uint16_t
+
+  typedef CatalogFormat::WordStart WordStart;
+
+private:
+  // Alleen-lezen view; wijst in eigen opslag of in een snapshot
+  template <typename T>
+  struct Array {
+    const T* data = nullptr;
+    uint32_t count = 0;
+
+    void bind(const std::vector<T>& v) { data = v.data(); count = v.size(); }
+    const T& operator[](size_t i) const { return data[i]; }
+    const T* begin() const { return data; }
+    const T* end() const { return data + count; }
+  };
+
+  // Eigen opslag (gebouwde catalogus)
+  std::vector<Item> ownedItems;
+  StringArena strings;
+  std::vector<uint16_t> ownedIdTable;
+  std::vector<uint16_t> ownedCategorySlots;
+  std::vector<char> ownedFoldedNames;
+  std::vector<uint32_t> ownedFoldedStart;
+  std::vector<WordStart> ownedWordIndex;
+
+  std::vector<uint8_t> snapshot;   // Snapshot in RAM (één heap blok)
+  bool inPlace = false;            // Snapshot van buiten (flash), niet van ons
+
+  // Actieve data
+  Array<Item> items;
+  Array<char> stringTable;
+  Array<uint16_t> idTable;         // Open addressing op id: slot + 1, 0 = leeg
+  Array<uint16_t> categorySlots;   // Slots per categorie, A-Z binnen de categorie
+  uint16_t categoryStart[ITEM_CATEGORY_COUNT + 1] = {};
+  uint16_t letterStart[LETTER_BUCKETS + 1] = {};  // Offsets in de gesorteerde items
+
+  // Zoek index: gevouwen namen en een gesorteerde tabel met het begin van
+  // elk woord. De tekst vanaf een woord-begin loopt door tot het eind van
+  // de naam, dus "plastic fl" matcht ook over woordgrenzen.
+  Array<char> foldedNames;
+  Array<uint32_t> foldedStart;     // Per slot: begin van de gevouwen naam
+  Array<WordStart> wordIndex;
+
+  // Fuzzy zoeken (tikfouten), begrensd in geheugen
+  TrigramIndex trigrams;
+  size_t fuzzyBudget = FUZZY_INDEX_BUDGET;
+
+  uint32_t dataVersion = 0;        // Versie van de API data (0 = onbekend)
+
+  // Catalogus volgorde: A-Z per letter bucket, zodat elke letter
+  // aaneengesloten is; gelijke namen op id (vaste volgorde)
+  struct ItemOrder {
+    const char* strings;
+    bool operator()(const Item& a, const Item& b) const {
+      const char* na = strings + a.nameOffset;
+      const char* nb = strings + b.nameOffset;
+      uint8_t ba = letterBucket(na);
+      uint8_t bb = letterBucket(nb);
+      if (ba != bb) return ba < bb;
+      int c = strcmp(na, nb);
+      return c != 0 ? c < 0 : a.id < b.id;
+    }
+  };
+
+  void bindStrings() {
+    stringTable.data = strings.base();
+    stringTable.count = strings.size();
+  }
+
+  void buildWordIndex() {
+    ownedFoldedNames.clear();
+    ownedFoldedStart.clear();
+    ownedWordIndex.clear();
+    ownedFoldedStart.reserve(items.count);
+    char folded[96];
+    for (size_t slot = 0; slot < items.count; slot++) {
+      size_t len = TextFold::fold(nameOf(items[slot]), folded, sizeof(folded));
+      uint32_t base = ownedFoldedNames.size();
+      ownedFoldedStart.push_back(base);
+      ownedFoldedNames.insert(ownedFoldedNames.end(), folded, folded + len + 1);
+      for (size_t i = 0; i < len; i++) {
+        if (i == 0 || folded[i - 1] == ' ') {
+          ownedWordIndex.push_back({(uint32_t)(base + i), (uint16_t)slot, 0});
+        }
+      }
+    }
+    ownedFoldedNames.shrink_to_fit();
+    ownedWordIndex.shrink_to_fit();
+
+    const char* text = ownedFoldedNames.data();
+    std::sort(ownedWordIndex.begin(), ownedWordIndex.end(), [text](const WordStart& a, const WordStart& b) {
+      int c = strcmp(text + a.offset, text + b.offset);
+      return c != 0 ? c < 0 : a.slot < b.slot;  // Vaste volgorde (zie catalog_pack.py)
+    });
+    foldedNames.bind(ownedFoldedNames);
+    foldedStart.bind(ownedFoldedStart);
+    wordIndex.bind(ownedWordIndex);
+
+    trigrams.build(items.count, [this](size_t slot) { return foldedNameOf(slot); }, fuzzyBudget);
+  }
+
+  static uint8_t letterBucket(const char* name) {
+    char c = toupper((unsigned char)name[0]);
+    return (c >= 'A' && c <= 'Z') ? c - 'A' : LETTER_BUCKETS - 1;
+  }
+
+  static uint32_t hashId(int32_t id, uint32_t mask) {
+    return ((uint32_t)id * 2654435761u) & mask;  // Knuth multiplicatief
+  }
+
+  // Na het (her)sorteren: buffers op maat maken en de indexen bouwen
+  void finishBuild() {
+    ownedItems.shrink_to_fit();
+    strings.finalize();
+    items.bind(ownedItems);
+    bindStrings();
+    buildIndexes();
+  }
+
+  void buildIndexes() {
+    size_t n = items.count;
+
+    // Letter offsets: items zijn op (letter bucket, naam) gesorteerd
+    uint16_t counts[LETTER_BUCKETS] = {};
+    for (const auto& item : items) counts[letterBucket(nameOf(item))]++;
+    letterStart[0] = 0;
+    for (uint8_t b = 0; b < LETTER_BUCKETS; b++) {
+      letterStart[b + 1] = letterStart[b] + counts[b];
+    }
+
+    // Categorie slot lijsten (counting sort, behoudt A-Z volgorde)
+    uint16_t catCounts[ITEM_CATEGORY_COUNT] = {};
+    for (const auto& item : items) catCounts[(uint8_t)item.category]++;
+    categoryStart[0] = 0;
+    for (uint8_t c = 0; c < ITEM_CATEGORY_COUNT; c++) {
+      categoryStart[c + 1] = categoryStart[c] + catCounts[c];
+    }
+    ownedCategorySlots.assign(n, 0);
+    uint16_t fill[ITEM_CATEGORY_COUNT];
+    std::copy(categoryStart, categoryStart + ITEM_CATEGORY_COUNT, fill);
+    for (size_t slot = 0; slot < n; slot++) {
+      ownedCategorySlots[fill[(uint8_t)items[slot].category]++] = slot;
+    }
+    categorySlots.bind(ownedCategorySlots);
+
+    // Id hash tabel, load factor <= 2/3
+    size_t tableSize = 16;
+    while (tableSize < n + n / 2) tableSize <<= 1;
+    ownedIdTable.assign(tableSize, 0);
+    uint32_t mask = tableSize - 1;
+    for (size_t slot = 0; slot < n; slot++) {
+      uint32_t i = hashId(items[slot].id, mask);
+      while (ownedIdTable[i] != 0) i = (i + 1) & mask;
+      ownedIdTable[i] = slot + 1;
+    }
+    idTable.bind(ownedIdTable);
+
+    buildWordIndex();
+  }
+
+  // Sectie uit de header koppelen na grens- en uitlijning controle
+  template <typename T>
+  static bool bindSection(Array<T>& array, const uint8_t* file, size_t fileSize,
+                          const CatalogFormat::SectionRef& ref) {
+    if (ref.offset % 4 != 0 || ref.offset > fileSize) return false;
+    if ((fileSize - ref.offset) / sizeof(T) < ref.count) return false;
+    array.data = reinterpret_cast<const T*>(file + ref.offset);
+    array.count = ref.count;
+    return true;
+  }
+
+  // Bucket grenzen: begint op 0, loopt niet terug en eindigt op n, zodat
+  // byLetter/byCategory/letterOffset binnen de tabellen blijven
+  static bool bucketsConsistent(const uint16_t* start, size_t buckets, uint32_t n) {
+    if (start[0] != 0 || start[buckets] != n) return false;
+    for (size_t b = 0; b < buckets; b++) {
+      if (start[b + 1] < start[b]) return false;
+    }
+    return true;
+  }
+
+  // Structuur controle na het koppelen: aantallen kloppen, tabellen
+  // eindigen op NUL en alle offsets blijven binnen hun sectie
+  bool sectionsConsistent(const CatalogFormat::CatalogFileHeader& h) const {
+    uint32_t n = h.itemCount;
+    if (n > MAX_ITEMS || items.count != n) return false;
+    if (categorySlots.count != n || foldedStart.count != n) return false;
+    if (stringTable.count == 0 || stringTable[stringTable.count - 1] != '\0') return false;
+    if (n > 0 && (foldedNames.count == 0 || foldedNames[foldedNames.count - 1] != '\0')) return false;
+    if (idTable.count < 16 || (idTable.count & (idTable.count - 1)) != 0) return false;
+    if (!bucketsConsistent(h.categoryStart, ITEM_CATEGORY_COUNT, n)) return false;
+    if (!bucketsConsistent(h.letterStart, LETTER_BUCKETS, n)) return false;
+    for (uint32_t i = 0; i < n; i++) {
+      const Item& item = items[i];
+      if (item.nameOffset >= stringTable.count || item.descriptionOffset >= stringTable.count) return false;
+      if ((uint8_t)item.category >= ITEM_CATEGORY_COUNT || categorySlots[i] >= n) return false;
+      if (foldedStart[i] >= foldedNames.count) return false;
+    }
+    for (const WordStart& w : wordIndex) {
+      if (w.offset >= foldedNames.count || w.slot >= n) return false;
+    }
+    for (uint16_t entry : idTable) {
+      if (entry > n) return false;
+    }
+    return true;
+  }
+
+  static bool trigramsConsistent(const Array<uint16_t>& keys, const Array<uint32_t>& starts,
+                                 const Array<uint16_t>& postings, uint32_t itemCount) {
+    if (starts.count != keys.count + 1 || starts[0] != 0 || starts[keys.count] != postings.count) return false;
+    for (uint32_t k = 0; k < keys.count; k++) {
+      if (starts[k] > starts[k + 1] || (k > 0 && keys[k - 1] >= keys[k])) return false;
+    }
+    for (uint16_t slot : postings) {
+      if (slot >= itemCount) return false;
+    }
+    return true;
+  }
+
+public:
+  Catalog() { bindStrings(); }
+
+  // Views wijzen in de eigen buffers; een vector verhuist zijn buffer mee,
+  // dus verplaatsen is veilig, kopiëren niet
+  Catalog(Catalog&&) = default;
+  Catalog& operator=(Catalog&&) = default;
+  Catalog(const Catalog&) = delete;
+  Catalog& operator=(const Catalog&) = delete;
+
+  void clear() {
+    // Buffers echt vrijgeven: na attach() hoort er niets op de heap te staan
+    std::vector<Item>().swap(ownedItems);
+    strings = StringArena();
+    std::vector<uint16_t>().swap(ownedIdTable);
+    std::vector<uint16_t>().swap(ownedCategorySlots);
+    std::vector<char>().swap(ownedFoldedNames);
+    std::vector<uint32_t>().swap(ownedFoldedStart);
+    std::vector<WordStart>().swap(ownedWordIndex);
+    std::vector<uint8_t>().swap(snapshot);
+    inPlace = false;
+    items = Array<Item>();
+    idTable = Array<uint16_t>();
+    categorySlots = Array<uint16_t>();
+    foldedNames = Array<char>();
+    foldedStart = Array<uint32_t>();
+    wordIndex = Array<WordStart>();
+    bindStrings();
+    trigrams.clear();
+    dataVersion = 0;
+    std::fill(categoryStart, categoryStart + ITEM_CATEGORY_COUNT + 1, 0);
+    std::fill(letterStart, letterStart + LETTER_BUCKETS + 1, 0);
+  }
+
+  void reserve(size_t itemCount, size_t stringBytes = 0) {
+    ownedItems.reserve(itemCount);
+    if (stringBytes) strings.reserve(stringBytes);
+  }
+
+  // Items boven MAX_ITEMS worden genegeerd (false)
+  bool add(int id, const char* name, const char* description,
+           ItemCategory category, uint16_t color, bool canBeDirty) {
+    if (ownedItems.size() >= MAX_ITEMS) return false;
+    Item item;
+    item.id = id;
+    item.nameOffset = strings.intern(name);
+    item.descriptionOffset = strings.intern(description);
+    item.color = color;
+    item.category = category;
+    item.canBeDirty = canBeDirty;
+    ownedItems.push_back(item);
+    return true;
+  }
+
+  // Sorteer A-Z (per letter bucket, zodat elke letter aaneengesloten is),
+  // maak de buffers op maat en bouw de indexen
+  void finalize() {
+    std::sort(ownedItems.begin(), ownedItems.end(), ItemOrder{strings.base()});
+    finishBuild();
+  }
+
+  // Delta toepassen: base zonder de verwijderde en gewijzigde ids, plus
+  // changes (nieuwe en gewijzigde items). base is al gesorteerd, dus
+  // alleen de wijzigingen worden gesorteerd en daarna in één lineaire
+  // merge ingevoegd. De indexen worden opnieuw gebouwd.
+  void mergeFrom(const Catalog& base, const Catalog& changes, const std::vector<int32_t>& removedIds) {
+    std::vector<int32_t> dropped(removedIds);
+    for (const Item& item : changes.all()) dropped.push_back(item.id);
+    std::sort(dropped.begin(), dropped.end());
+
+    clear();
+    reserve(base.size() + changes.size(), base.stringBytes());
+    for (const Item& item : base.all()) {
+      if (std::binary_search(dropped.begin(), dropped.end(), item.id)) continue;
+      add(item.id, base.nameOf(item), base.descriptionOf(item), item.category, item.color, item.canBeDirty);
+    }
+    size_t kept = ownedItems.size();
+    for (const Item& item : changes.all()) {
+      add(item.id, changes.nameOf(item), changes.descriptionOf(item), item.category, item.color,
+          item.canBeDirty);
+    }
+
+    ItemOrder order{strings.base()};
+    std::sort(ownedItems.begin() + kept, ownedItems.end(), order);
+    std::inplace_merge(ownedItems.begin(), ownedItems.begin() + kept, ownedItems.end(), order);
+    finishBuild();
+  }
+
+  // Alleen de items waarvan het id in allowedIds (gesorteerd) staat, bijv.
+  // wat in de bak op deze locatie mag. base is al gesorteerd en die
+  // volgorde blijft; alleen de indexen worden opnieuw gebouwd. De data
+  // versie blijft die van base (delta's bouwen daarop voort).
+  void filterFrom(const Catalog& base, const std::vector<int32_t>& allowedIds) {
+    clear();
+    size_t count = 0;
+    for (const Item& item : base.all()) {
+      if (std::binary_search(allowedIds.begin(), allowedIds.end(), item.id)) count++;
+    }
+    reserve(count);
+    for (const Item& item : base.all()) {
+      if (!std::binary_search(allowedIds.begin(), allowedIds.end(), item.id)) continue;
+      add(item.id, base.nameOf(item), base.descriptionOf(item), item.category, item.color, item.canBeDirty);
+    }
+    finishBuild();
+    dataVersion = base.getDataVersion();
+  }
+
+  // ========== BINAIR SNAPSHOT ==========
+
+  // Gebruik een snapshot in place, zonder kopie (bijv. flash via
+  // esp_partition_mmap). data moet blijven bestaan zolang deze catalogus
+  // hem gebruikt. Bij een fout blijft de catalogus leeg en wijst error
+  // (optioneel) naar de reden.
+  bool attach(const uint8_t* data, size_t size, const char** error = nullptr) {
+    using namespace CatalogFormat;
+    const char* reason = nullptr;
+    clear();
+
+    const CatalogFileHeader* h = reinterpret_cast<const CatalogFileHeader*>(data);
+    if (size < sizeof(CatalogFileHeader)) reason = "too small";
+    else if (h->magic != MAGIC) reason = "bad magic";
+    else if (h->version != VERSION || h->headerSize != sizeof(CatalogFileHeader)) reason = "unsupported version";
+    else if (h->totalSize > size || h->totalSize < h->headerSize) reason = "truncated";
+    else if (fileCrc(data, h->totalSize) != h->crc32) reason = "crc mismatch";
+
+    if (!reason) {
+      size_t total = h->totalSize;
+      Array<uint16_t> keys, postings;
+      Array<uint32_t> starts;
+      bool ok = bindSection(items, data, total, h->sections[ITEMS])
+        && bindSection(stringTable, data, total, h->sections[STRINGS])
+        && bindSection(idTable, data, total, h->sections[ID_TABLE])
+        && bindSection(categorySlots, data, total, h->sections[CATEGORY_SLOTS])
+        && bindSection(foldedNames, data, total, h->sections[FOLDED_NAMES])
+        && bindSection(foldedStart, data, total, h->sections[FOLDED_START])
+        && bindSection(wordIndex, data, total, h->sections[WORD_INDEX])
+        && bindSection(keys, data, total, h->sections[TRIGRAM_KEYS])
+        && bindSection(starts, data, total, h->sections[TRIGRAM_STARTS])
+        && bindSection(postings, data, total, h->sections[TRIGRAM_POSTINGS])
+        && trigramsConsistent(keys, starts, postings, h->itemCount)
+        && sectionsConsistent(*h);
+      if (ok) {
+        std::copy(h->categoryStart, h->categoryStart + ITEM_CATEGORY_COUNT + 1, categoryStart);
+        std::copy(h->letterStart, h->letterStart + LETTER_BUCKETS + 1, letterStart);
+        trigrams.attach(keys.data, keys.count, starts.data, postings.data, postings.count,
+                        h->trigramListCap);
+        dataVersion = h->dataVersion;
+        inPlace = true;
+        return true;
+      }
+      reason = "corrupt sections";
+    }
+
+    clear();
+    if (error) *error = reason;
+    return false;
+  }
+
+  // Snapshot uit een RAM buffer (bijv. gelezen uit LittleFS). Neemt de
+  // buffer over: de hele catalogus is dan één heap blok.
+  bool loadSnapshot(std::vector<uint8_t>&& buffer, const char** error = nullptr) {
+    std::vector<uint8_t> data(std::move(buffer));
+    if (!attach(data.data(), data.size(), error)) return false;
+    snapshot = std::move(data);  // Buffer verhuist mee, de views blijven geldig
+    inPlace = false;
+    return true;
+  }
+
+  // Schrijf deze catalogus als binair snapshot (zie CatalogFormat)
+  void serialize(std::vector<uint8_t>& out) const {
+    using namespace CatalogFormat;
+    CatalogFileHeader h;
+    memset(&h, 0, sizeof(h));
+    h.magic = MAGIC;
+    h.version = VERSION;
+    h.headerSize = sizeof(CatalogFileHeader);
+    h.itemCount = items.count;
+    h.trigramListCap = trigrams.getListCap();
+    h.dataVersion = dataVersion;
+    std::copy(categoryStart, categoryStart + ITEM_CATEGORY_COUNT + 1, h.categoryStart);
+    std::copy(letterStart, letterStart + LETTER_BUCKETS + 1, h.letterStart);
+
+    out.assign(sizeof(CatalogFileHeader), 0);
+    auto append = [&out, &h](Section section, const void* data, uint32_t count) {
+      while (out.size() % 4) out.push_back(0);
+      h.sections[section].offset = out.size();
+      h.sections[section].count = count;
+      const uint8_t* bytes = static_cast<const uint8_t*>(data);
+      if (count) out.insert(out.end(), bytes, bytes + count * elementSize(section));
+    };
+    // Strings in slot volgorde (eerst alle namen, dan beschrijvingen): een
+    // grid pagina leest dan aaneengesloten flash in plaats van verspreide
+    // blokken (zie tools/bench/paging_bench.cpp)
+    StringArena layout;
+    std::vector<Item> records(items.data, items.data + items.count);
+    for (Item& item : records) item.nameOffset = layout.intern(nameOf(item));
+    for (size_t slot = 0; slot < items.count; slot++) {
+      records[slot].descriptionOffset = layout.intern(descriptionOf(items[slot]));
+    }
+
+    uint32_t keyCount = trigrams.trigramCount();
+    static const uint32_t noPostings = 0;  // Lege index: starts = {0}
+    append(ITEMS, records.data(), records.size());
+    append(STRINGS, layout.base(), layout.size());
+    append(ID_TABLE, idTable.data, idTable.count);
+    append(CATEGORY_SLOTS, categorySlots.data, categorySlots.count);
+    append(FOLDED_NAMES, foldedNames.data, foldedNames.count);
+    append(FOLDED_START, foldedStart.data, foldedStart.count);
+    append(WORD_INDEX, wordIndex.data, wordIndex.count);
+    append(TRIGRAM_KEYS, trigrams.getKeys(), keyCount);
+    append(TRIGRAM_STARTS, trigrams.getStarts() ? trigrams.getStarts() : &noPostings, keyCount + 1);
+    append(TRIGRAM_POSTINGS, trigrams.getPostings(), trigrams.postingCount());
+    while (out.size() % 4) out.push_back(0);
+
+    h.totalSize = out.size();
+    h.crc32 = 0;
+    memcpy(out.data(), &h, sizeof(h));
+    h.crc32 = fileCrc(out.data(), out.size());
+    memcpy(out.data() + offsetof(CatalogFileHeader, crc32), &h.crc32, sizeof(h.crc32));
+  }
+
+  // ========== LOOKUPS ==========
+
+  const char* nameOf(const Item& item) const { return stringTable.data + item.nameOffset; }
+  const char* descriptionOf(const Item& item) const { return stringTable.data + item.descriptionOffset; }
+
+  ItemSpan all() const { return ItemSpan(items.data, items.count); }
+  size_t size() const { return items.count; }
+  bool empty() const { return items.count == 0; }
+  const Item& operator[](size_t slot) const { return items[slot]; }
+
+  // O(1) verwacht
+  const Item* findById(int id) const {
+    if (idTable.count == 0) return nullptr;
+    uint32_t mask = idTable.count - 1;
+    uint32_t i = hashId(id, mask);
+    while (idTable[i] != 0) {
+      const Item& item = items[idTable[i] - 1];
+      if (item.id == id) return &item;
+      i = (i + 1) & mask;
+    }
+    return nullptr;
+  }
+
+  // Aaneengesloten deel van de gesorteerde catalogus; niet A-Z = overig
+  ItemSpan byLetter(char letter) const {
+    char c = toupper((unsigned char)letter);
+    uint8_t b = (c >= 'A' && c <= 'Z') ? c - 'A' : LETTER_BUCKETS - 1;
+    return ItemSpan(items.data + letterStart[b], letterStart[b + 1] - letterStart[b]);
+  }
+
+  size_t letterCount(uint8_t bucket) const {
+    return letterStart[bucket + 1] - letterStart[bucket];
+  }
+
+  // Slot van het eerste item met deze letter (voor scrollen naar een letter)
+  size_t letterOffset(uint8_t bucket) const { return letterStart[bucket]; }
+
+  IndexedItemRange byCategory(ItemCategory category) const {
+    uint8_t c = (uint8_t)category;
+    if (c >= ITEM_CATEGORY_COUNT) return IndexedItemRange();
+    return IndexedItemRange(items.data, categorySlots.data + categoryStart[c],
+                            categoryStart[c + 1] - categoryStart[c]);
+  }
+
+  // Roept onMatch(slot) aan voor elk woord dat met prefix begint (prefix
+  // moet al gevouwen zijn, zie TextFold). Een item kan vaker matchen.
+  // O(log w + treffers) via binair zoeken in de woord tabel.
+  template <typename F>
+  void forEachPrefixMatch(const char* prefix, F onMatch) const {
+    size_t len = strlen(prefix);
+    const char* text = foldedNames.data;
+    const WordStart* it = std::lower_bound(wordIndex.begin(), wordIndex.end(), prefix,
+      [text](const WordStart& w, const char* p) { return strcmp(text + w.offset, p) < 0; });
+    for (; it != wordIndex.end() && strncmp(text + it->offset, prefix, len) == 0; ++it) {
+      onMatch(it->slot);
+    }
+  }
+
+  size_t wordCount() const { return wordIndex.count; }
+
+  // Gevouwen naam (kleine letters, zonder accenten) voor zoeken
+  const char* foldedNameOf(size_t slot) const { return foldedNames.data + foldedStart[slot]; }
+
+  const TrigramIndex& getTrigramIndex() const { return trigrams; }
+
+  // Geheugen limiet voor de trigram index; geldt bij de volgende finalize()
+  void setFuzzyBudget(size_t bytes) { fuzzyBudget = bytes; }
+
+  // Versie van de API data waar deze catalogus op gebaseerd is (voor
+  // delta sync); wordt in het binaire snapshot bewaard
+  uint32_t getDataVersion() const { return dataVersion; }
+  void setDataVersion(uint32_t version) { dataVersion = version; }
+
+  // ========== GEHEUGEN ==========
+
+  // Items direct uit flash (partitie of ingebouwd), niet in RAM
+  bool isInPlace() const { return inPlace; }
+
+  // Waar de data staat: zelf gebouwd, snapshot in RAM of in place (flash)
+  const char* storageName() const {
+    if (inPlace) return "in place";
+    return snapshot.empty() ? "built" : "snapshot";
+  }
+
+  // Grootte van de secties, ongeacht waar ze staan
+  size_t itemBytes() const { return items.count * sizeof(Item); }
+  size_t stringBytes() const { return stringTable.count; }
+  size_t indexBytes() const {
+    return (idTable.count + categorySlots.count) * sizeof(uint16_t)
+         + foldedNames.count + foldedStart.count * sizeof(uint32_t)
+         + wordIndex.count * sizeof(WordStart) + trigrams.memoryUsage();
+  }
+  size_t memoryUsage() const { return itemBytes() + stringBytes() + indexBytes(); }
+
+  // Wat deze catalogus echt op de heap houdt (~0 bij een snapshot in flash)
+  size_t heapBytes() const {
+    return ownedItems.capacity() * sizeof(Item) + strings.capacity()
+         + (ownedIdTable.capacity() + ownedCategorySlots.capacity()) * sizeof(uint16_t)
+         + ownedFoldedNames.capacity() + ownedFoldedStart.capacity() * sizeof(uint32_t)
+         + ownedWordIndex.capacity() * sizeof(WordStart) + trigrams.heapBytes()
+         + snapshot.capacity();
+  }
+  uint32_t internedBytesSaved() const { return strings.getBytesSaved(); }
+};
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef CATALOG_FORMAT_H
+#define CATALOG_FORMAT_H
+
+#include <cstdint>
+#include <cstddef>
+#include "Item.h"
+
+#if defined(ESP_PLATFORM)
+#include <esp_rom_crc.h>
+#endif
+
+// Binair catalogus snapshot (little-endian), direct bruikbaar vanuit
+// flash of een RAM buffer zonder parsen:
+//
+//   [CatalogFileHeader][secties...]
+//
+// Elke sectie begint op een 4-byte grens; offsets zijn vanaf het begin
+// van het bestand. De CRC32 (IEEE, zelfde als zlib.crc32) dekt het hele
+// bestand inclusief de header, met het crc32 veld zelf als nullen.
+// tools/catalog_pack.py schrijft hetzelfde formaat.
+namespace CatalogFormat {
+
+const uint32_t MAGIC = 0x54434252;  // "RBCT"
+const uint16_t VERSION = 3;  // 2: dataVersion in de header, 3: CRC over het hele bestand
+const uint8_t LETTER_BUCKETS = 27;
+
+enum Section : uint8_t {
+  ITEMS,             // Item[itemCount]
+  STRINGS,           // char[]: NUL-terminated, offset 0 = ""
+  ID_TABLE,          // uint16_t[2^k]: slot + 1, 0 = leeg
+  CATEGORY_SLOTS,    // uint16_t[itemCount]
+  FOLDED_NAMES,      // char[]: gevouwen namen, NUL-terminated
+  FOLDED_START,      // uint32_t[itemCount]
+  WORD_INDEX,        // WordStart[]: gesorteerd op tekst vanaf offset
+  TRIGRAM_KEYS,      // uint16_t[]: gesorteerd
+  TRIGRAM_STARTS,    // uint32_t[keys + 1]
+  TRIGRAM_POSTINGS,  // uint16_t[]
+  SECTION_COUNT
+};
+
+struct SectionRef {
+  uint32_t offset;
+  uint32_t count;    // Aantal elementen (niet bytes)
+};
+
+struct WordStart {
+  uint32_t offset;   // In FOLDED_NAMES
+  uint16_t slot;
+  uint16_t reserved;
+};
+
+struct CatalogFileHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t headerSize;
+  uint32_t totalSize;
+  uint32_t crc32;
+  uint32_t itemCount;
+  uint32_t trigramListCap;     // 0 = lijsten niet ingekort
+  uint32_t dataVersion;        // Catalogus versie van de API (0 = onbekend)
+  uint16_t categoryStart[ITEM_CATEGORY_COUNT + 1];
+  uint16_t letterStart[LETTER_BUCKETS + 1];
+  uint16_t reserved;
+  SectionRef sections[SECTION_COUNT];
+};
+
+static_assert(sizeof(WordStart) == 8, "WordStart layout changed");
+static_assert(sizeof(CatalogFileHeader) == 28 + 10 + 56 + 2 + 8 * SECTION_COUNT,
+              "CatalogFileHeader layout changed");
+
+inline size_t elementSize(uint8_t section) {
+  switch (section) {
+    case ITEMS: return sizeof(Item);
+    case STRINGS:
+    case FOLDED_NAMES: return 1;
+    case ID_TABLE:
+    case CATEGORY_SLOTS:
+    case TRIGRAM_KEYS:
+    case TRIGRAM_POSTINGS: return 2;
+    case FOLDED_START:
+    case TRIGRAM_STARTS: return 4;
+    case WORD_INDEX: return sizeof(WordStart);
+    default: return 0;
+  }
+}
+
+// crc = vorige uitkomst om door te rekenen (zoals zlib.crc32(data, crc))
+inline uint32_t crc32(const uint8_t* data, size_t length, uint32_t crc = 0) {
+#if defined(ESP_PLATFORM)
+  return esp_rom_crc32_le(crc, data, length);
+#else
+  static uint32_t table[256];
+  if (table[1] == 0) {
+    for (uint32_t i = 0; i < 256; i++) {
+      uint32_t c = i;
+      for (int b = 0; b < 8; b++) c = (c >> 1) ^ (0xEDB88320 & (0 - (c & 1)));
+      table[i] = c;
+    }
+  }
+  crc = ~crc;
+  for (size_t i = 0; i < length; i++) crc = (crc >> 8) ^ table[(crc ^ data[i]) & 0xFF];
+  return ~crc;
+#endif
+}
+
+// CRC van het hele bestand (totalSize bytes) met het crc32 veld als nullen
+inline uint32_t fileCrc(const uint8_t* data, size_t total) {
+  const size_t field = offsetof(CatalogFileHeader, crc32);
+  const uint8_t zero[sizeof(uint32_t)] = {};
+  uint32_t crc = crc32(data, field);
+  crc = crc32(zero, sizeof(zero), crc);
+  return crc32(data + field + sizeof(zero), total - field - sizeof(zero), crc);
+}
+
+}  // namespace CatalogFormat
+
+#endif
@@ -1,25 +1,30 @@
 #ifndef ITEM_H
 #define ITEM_H
 
-#include <Arduino.h>
+#include <cstdint>
 #include <cstring>
+#include <cctype>
+#include <type_traits>
 
-enum class ItemCategory {
+enum class ItemCategory : uint8_t {
   PLASTIC,
   PAPER,
   GREEN,
   WASTE
 };
 
+const uint8_t ITEM_CATEGORY_COUNT = 4;
+
+// Compact, trivially-copyable record (16 bytes). Naam en omschrijving
+// staan als offset in de string arena van de Catalog die het item bevat;
+// lees ze via Catalog::nameOf() / descriptionOf().
 struct Item {
-  int id;
-  String name;           
-  ItemCategory category;
+  int32_t id;
+  uint32_t nameOffset;
+  uint32_t descriptionOffset;
   uint16_t color;
-  bool isDirty;          
-  bool canBeDirty;       
-  int ledIndex;
-  String description;    
+  ItemCategory category;
+  bool canBeDirty;       // Schoon/vies keuze is per sessie, niet per item
 
   static const char* categoryToString(ItemCategory cat) {
     switch (cat) {
@@ -33,15 +38,21 @@ struct Item {
 
   static ItemCategory stringToCategory(const char* str) {
     // Case-insensitive vergelijking
-    String s = String(str);
-    s.toLowerCase();
+    auto is = [str](const char* s) {
+      const char* a = str;
+      while (*a && *s && tolower((unsigned char)*a) == *s) { a++; s++; }
+      return *a == '\0' && *s == '\0';
+    };
     
-    if (s == "plastic") return ItemCategory::PLASTIC;
-    if (s == "paper" || s == "papier") return ItemCategory::PAPER;
-    if (s == "green" || s == "groen" || s == "gft") return ItemCategory::GREEN;
-    if (s == "waste" || s == "rest" || s == "restafval") return ItemCategory::WASTE;
+    if (is("plastic")) return ItemCategory::PLASTIC;
+    if (is("paper") || is("papier")) return ItemCategory::PAPER;
+    if (is("green") || is("groen") || is("gft")) return ItemCategory::GREEN;
+    if (is("waste") || is("rest") || is("restafval")) return ItemCategory::WASTE;
     return ItemCategory::WASTE;
   }
 };
 
-#endif
\ No newline at end of file
+static_assert(std::is_trivially_copyable<Item>::value, "Item must stay POD");
+static_assert(sizeof(Item) == 16, "Item layout changed");
+
+#endif
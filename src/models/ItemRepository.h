@@ -2,30 +2,62 @@
 #define ITEM_REPOSITORY_H
 
 #include "Item.h"
+#include "ItemView.h"
+#include "Catalog.h"
 #include <vector>
 #include <algorithm>
 #include <ArduinoJson.h>
 #include <LittleFS.h>
+#include <esp_partition.h>
+#include <esp_idf_version.h>
 #include "../services/DatabaseService.h"
+#include "../services/NetworkService.h"
+#include "../diagnostics/Tracer.h"
+
+// Catalogus uit data/catalogus.json, bij de build in flash gezet
+// (tools/gen_catalog_header.py als PlatformIO pre-script)
+#if __has_include("../generated/CatalogBuiltin.h")
+#include "../generated/CatalogBuiltin.h"
+#define HAS_BUILTIN_CATALOG 1
+#endif
 
 class ItemRepository {
 private:
-  std::vector<Item> items;
+  Catalog catalog;
   bool dataFromDatabase = false;
   bool usingCachedData = false;
   String dataSource = "local";
+  uint32_t version = 0;  // Verhoogd bij elke (her)laad - schermen herladen dan hun views
+
+  // Achtergrond sync: tweede buffer tot de wissel (zie publishStagedCatalog)
+  Catalog staged;
+  bool hasStaged = false;
+  bool refreshPending = false;
+  uint32_t stagedAt = 0;
+  uint32_t swaps = 0;
+  uint32_t lastSwapUs = 0;
+  uint32_t maxSwapUs = 0;
+  uint32_t lastSwapWaitMs = 0;
+
+  // Bak filter: alleen items die hier weggegooid mogen worden. Generaties
+  // houden bij met welk filter de live/klaarstaande catalogus gebouwd is.
+  BinFilter binFilter;
+  uint32_t filterGeneration = 0;
+  uint32_t catalogFilterGeneration = 0;
+  uint32_t requestedFilterGeneration = 0;
+  uint32_t stagedFilterGeneration = 0;
+
+  // Laatste sync paste niet in RAM (met dit filter). Zolang de live
+  // catalogus in place uit flash komt niet telkens alles downloaden.
+  bool tooLargeForRam = false;
+  uint32_t tooLargeFilterGeneration = 0;
 
   ItemRepository() {}
 
-  // Sort items alphabetically by name
-  void sortItemsAlphabetically() {
-    std::sort(items.begin(), items.end(), [](const Item& a, const Item& b) {
-      return a.name < b.name;
-    });
-    // Update ledIndex after sorting
-    for (size_t i = 0; i < items.size(); i++) {
-      items[i].ledIndex = i;
-    }
+  // Sorteer A-Z, maak buffers op maat en laat schermen opnieuw syncen
+  void commitCatalog() {
+    catalog.finalize();
+    version++;
   }
 
 public:
@@ -34,78 +66,48 @@ public:
     return instance;
   }
 
-  void addItem(const Item& item) {
-    items.push_back(item);
+  // Zero-copy view op de hele (gesorteerde) catalogus
+  ItemSpan getAllItems() const {
+    return catalog.all();
   }
 
-  std::vector<Item> getAllItems() const {
-    return items;
-  }
+  const Catalog& getCatalog() const { return catalog; }
 
-  // Get items by starting letter (for alphabetical sidebar)
-  std::vector<Item> getItemsByLetter(char letter) const {
-    std::vector<Item> filtered;
-    char upperLetter = toupper(letter);
-    for (const auto& item : items) {
-      if (item.name.length() > 0 && toupper(item.name[0]) == upperLetter) {
-        filtered.push_back(item);
-      }
-    }
-    return filtered;
+  // Strings staan in de arena van de catalogus
+  const char* nameOf(const Item& item) const { return catalog.nameOf(item); }
+  const char* descriptionOf(const Item& item) const { return catalog.descriptionOf(item); }
+
+  // Get items by starting letter (for alphabetical sidebar) - O(1), geen kopie
+  ItemSpan getItemsByLetter(char letter) const {
+    return catalog.byLetter(letter);
   }
 
-  // Get all unique starting letters
+  // Get all unique starting letters (uit de letter index)
   std::vector<char> getAvailableLetters() const {
     std::vector<char> letters;
-    for (const auto& item : items) {
-      if (item.name.length() > 0) {
-        char letter = toupper(item.name[0]);
-        bool found = false;
-        for (char l : letters) {
-          if (l == letter) { found = true; break; }
-        }
-        if (!found) letters.push_back(letter);
-      }
+    for (uint8_t b = 0; b < 26; b++) {
+      if (catalog.letterCount(b) > 0) letters.push_back('A' + b);
     }
-    std::sort(letters.begin(), letters.end());
     return letters;
   }
 
-  std::vector<Item> getItemsByCategory(ItemCategory category) const {
-    std::vector<Item> filtered;
-    for (const auto& item : items) {
-      if (item.category == category) {
-        filtered.push_back(item);
-      }
-    }
-    return filtered;
+  IndexedItemRange getItemsByCategory(ItemCategory category) const {
+    return catalog.byCategory(category);
   }
 
-  Item* getItemById(int id) {
-    for (auto& item : items) {
-      if (item.id == id) {
-        return &item;
-      }
-    }
-    return nullptr;
+  // O(1) via de id index
+  const Item* getItemById(int id) const {
+    return catalog.findById(id);
   }
 
-  // Load items from JSON file
-  bool loadFromJSON(const char* filename = "/catalogus.json") {
-    items.clear();
-
-    if (!LittleFS.begin(true)) {
-      Serial.println("LittleFS mount failed!");
-      return false;
-    }
-
+  // Parse een catalogus JSON bestand (ArduinoJson v6) naar een Catalog
+  static bool parseJSONFile(const char* filename, Catalog& out) {
     File file = LittleFS.open(filename, "r");
     if (!file) {
       Serial.printf("Failed to open %s\n", filename);
       return false;
     }
 
-    // Parse JSON (ArduinoJson v6)
     DynamicJsonDocument doc(32768);  // 32KB for 84 items
     DeserializationError error = deserializeJson(doc, file);
     file.close();
@@ -115,102 +117,294 @@ public:
       return false;
     }
 
+    out.clear();
     JsonArray itemsArray = doc["items"];
+    out.reserve(itemsArray.size());
     
     for (JsonObject obj : itemsArray) {
-      Item item;
-      item.id = obj["id"] | 0;
-      item.name = String(obj["name"] | "Unknown");
-      item.description = String(obj["description"] | "");
-      
       // Parse category
       const char* cat = obj["category"] | "waste";
-      item.category = Item::stringToCategory(cat);
       
       // Parse color (hex string like "0xFD20")
       const char* colorStr = obj["color"] | "0x6B4D";
-      item.color = (uint16_t)strtol(colorStr, NULL, 16);
-      
-      item.isDirty = false;
-      item.canBeDirty = obj["canBeDirty"] | false;
-      item.ledIndex = items.size();
 
-      items.push_back(item);
+      out.add(obj["id"] | 0,
+              obj["name"] | "Unknown",
+              obj["description"] | "",
+              Item::stringToCategory(cat),
+              (uint16_t)strtol(colorStr, NULL, 16),
+              obj["canBeDirty"] | false);
     }
 
     // Sort alphabetically after loading
-    sortItemsAlphabetically();
+    out.finalize();
+    return true;
+  }
+
+  // Load items from JSON file
+  bool loadFromJSON(const char* filename = "/catalogus.json") {
+    TRACE_SCOPE(TraceName::REPO_LOAD_JSON);
+    catalog.clear();
+
+    if (!LittleFS.begin(true)) {
+      Serial.println("LittleFS mount failed!");
+      return false;
+    }
+
+    if (!parseJSONFile(filename, catalog)) return false;
+    version++;
 
-    Serial.printf("Loaded %d items from JSON (sorted A-Z)\n", items.size());
+    Serial.printf("Loaded %d items from JSON (sorted A-Z)\n", catalog.size());
     return true;
   }
 
-  // Fallback: hardcoded items (for testing without filesystem)
-  void loadHardcodedItems() {
-    Serial.println("Loading items...");
-    items.clear();
-    
-    // Try database first, then JSON, then hardcoded
-    if (loadFromDatabase()) {
-      return;
+  // Catalogus partitie in flash, eenmalig gemapt en daarna voor altijd
+  // geldig (de data wordt in place gebruikt). nullptr als er geen is.
+  static const uint8_t* mapCatalogPartition(size_t& size) {
+    static const uint8_t* mapped = nullptr;
+    static size_t mappedSize = 0;
+    static bool tried = false;
+    if (!tried) {
+      tried = true;
+      const esp_partition_t* part = esp_partition_find_first(
+        ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)CATALOG_PARTITION_SUBTYPE,
+        CATALOG_PARTITION_LABEL);
+      if (!part) {
+        Serial.println("No catalog partition");
+      } else {
+        const void* ptr = nullptr;
+#if ESP_IDF_VERSION_MAJOR >= 5
+        esp_partition_mmap_handle_t handle;
+        esp_err_t err = esp_partition_mmap(part, 0, part->size, ESP_PARTITION_MMAP_DATA, &ptr, &handle);
+#else
+        spi_flash_mmap_handle_t handle;
+        esp_err_t err = esp_partition_mmap(part, 0, part->size, SPI_FLASH_MMAP_DATA, &ptr, &handle);
+#endif
+        if (err == ESP_OK) {
+          mapped = static_cast<const uint8_t*>(ptr);
+          mappedSize = part->size;
+        } else {
+          Serial.printf("Catalog partition mmap failed: %d\n", err);
+        }
+      }
     }
-    
-    if (loadFromJSON()) {
-      return;
+    size = mappedSize;
+    return mapped;
+  }
+
+  // Binaire catalogus uit de flash partitie (tools/catalog_pack.py):
+  // geen parse en geen heap, items worden direct uit flash gelezen
+  bool loadFromPartition() {
+    TRACE_SCOPE(TraceName::REPO_LOAD_PARTITION);
+    size_t size = 0;
+    const uint8_t* data = mapCatalogPartition(size);
+    if (!data) return false;
+
+    const char* error = nullptr;
+    Catalog mapped;
+    if (!mapped.attach(data, size, &error)) {
+      Serial.printf("Catalog partition rejected: %s\n", error);
+      return false;
     }
-    
-    Serial.println("JSON load failed, using hardcoded items");
-    
-    Item i1; i1.id = 1; i1.name = "Plastic Fles"; i1.category = ItemCategory::PLASTIC; 
-    i1.color = 0xFD20; i1.isDirty = false; i1.canBeDirty = true; i1.ledIndex = 0; i1.description = "Leeg en gespoeld";
-    items.push_back(i1);
-    
-    Item i2; i2.id = 2; i2.name = "Papier"; i2.category = ItemCategory::PAPER;
-    i2.color = 0x001F; i2.isDirty = false; i2.canBeDirty = false; i2.ledIndex = 1; i2.description = "Onbeschadigd papier";
-    items.push_back(i2);
-    
-    Item i3; i3.id = 3; i3.name = "Appel"; i3.category = ItemCategory::GREEN;
-    i3.color = 0x07E0; i3.isDirty = false; i3.canBeDirty = false; i3.ledIndex = 2; i3.description = "Biologisch afval";
-    items.push_back(i3);
-    
-    Item i4; i4.id = 4; i4.name = "Blikje"; i4.category = ItemCategory::WASTE;
-    i4.color = 0x8410; i4.isDirty = false; i4.canBeDirty = false; i4.ledIndex = 3; i4.description = "Aluminium blikje";
-    items.push_back(i4);
+    catalog = std::move(mapped);
+    version++;
+    return true;
   }
 
-  // Load items from remote database API
-  bool loadFromDatabase() {
+  // Instant-on: laatste lokale snapshot, zonder netwerk
+  // (db cache -> flash partitie -> gebundelde JSON -> ingebouwd)
+  void loadLocalItems() {
+    Serial.println("Loading items from local snapshot...");
     DatabaseService& db = DatabaseService::getInstance();
-    
-    Serial.println("Attempting to load from database API...");
-    
-    std::vector<Item> dbItems;
-    if (db.fetchItems(dbItems) && dbItems.size() > 0) {
-      items = dbItems;
-      dataFromDatabase = true;
-      usingCachedData = db.isUsingCachedData();
-      dataSource = db.getDataSource();
-      
-      // Sort alphabetically
-      sortItemsAlphabetically();
-      
-      Serial.printf("Loaded %d items from %s\n", items.size(), dataSource.c_str());
-      return true;
+    uint32_t start = micros();
+
+    Catalog cached;
+    if (db.loadCachedItems(cached)) {
+      catalog = std::move(cached);
+      usingCachedData = true;
+      dataSource = "local_cache";
+      version++;
+    } else if (loadFromPartition()) {
+      usingCachedData = true;
+      dataSource = "flash";
+    } else if (loadFromJSON()) {
+      usingCachedData = true;
+      dataSource = "local_json";
+    } else if (!loadBuiltinItems()) {
+      loadHardcodedItems();
     }
-    
-    Serial.println("Database load failed, trying local JSON...");
+    if (db.loadBinFilter(binFilter)) applyBinFilter();
+
+    Serial.printf("Catalog: %d items from %s (%s) in %lu us, %u bytes heap\n",
+                  catalog.size(), dataSource.c_str(), catalog.storageName(),
+                  (unsigned long)(micros() - start), (unsigned)catalog.heapBytes());
+  }
+
+  // Lokale catalogus (partitie, JSON, ingebouwd) terugbrengen tot de items
+  // van deze bak. De gecachte API catalogus is al gefilterd: dan niets te doen.
+  bool applyBinFilter() {
+    bool needed = false;
+    for (const Item& item : catalog.all()) {
+      if (!std::binary_search(binFilter.itemIds.begin(), binFilter.itemIds.end(), item.id)) {
+        needed = true;
+        break;
+      }
+    }
+    if (!needed || !HeapWatermark::fits(2 * catalog.memoryUsage(), CATALOG_MIN_FREE_HEAP)) return false;
+
+    Catalog filtered;
+    filtered.filterFrom(catalog, binFilter.itemIds);
+    if (filtered.empty()) return false;  // Filter past niet bij deze data: alles tonen
+    Serial.printf("Bin filter (trash bin %d): %d of %d items\n", (int)binFilter.trashbinId,
+                  filtered.size(), catalog.size());
+    catalog = std::move(filtered);
+    version++;
+    return true;
+  }
+
+  // Ingebouwde catalogus uit de firmware (rodata in flash): zelfde
+  // snapshot formaat als de partitie, dus geen parse en geen heap
+  bool loadBuiltinItems() {
+#ifdef HAS_BUILTIN_CATALOG
+    const char* error = nullptr;
+    Catalog builtin;
+    if (!builtin.attach(CATALOG_BUILTIN, sizeof(CATALOG_BUILTIN), &error)) {
+      Serial.printf("Builtin catalog rejected: %s\n", error);
+      return false;
+    }
+    catalog = std::move(builtin);
+    usingCachedData = true;
+    dataSource = "builtin";
+    version++;
+    return true;
+#else
     return false;
+#endif
   }
-  
-  // Post item selection to database
-  bool postItemSelection(const String& location, const Item& item) {
+
+  // Laatste fallback: hardcoded items (firmware zonder ingebouwde catalogus)
+  void loadHardcodedItems() {
+    Serial.println("No local catalog, using hardcoded items");
+    catalog.clear();
+    usingCachedData = true;
+    dataSource = "hardcoded";
+    
+    catalog.add(1, "Plastic Fles", "Leeg en gespoeld", ItemCategory::PLASTIC, 0xFD20, true);
+    catalog.add(2, "Papier", "Onbeschadigd papier", ItemCategory::PAPER, 0x001F, false);
+    catalog.add(3, "Appel", "Biologisch afval", ItemCategory::GREEN, 0x07E0, false);
+    catalog.add(4, "Blikje", "Aluminium blikje", ItemCategory::WASTE, 0x8410, false);
+    commitCatalog();
+  }
+
+  // Resultaat van een achtergrond sync (UI thread). Een nieuwe catalogus
+  // (volledig of al samengevoegd op de netwerk taak) komt in de tweede
+  // buffer en wordt pas bij publishStagedCatalog() zichtbaar. nullptr =
+  // sync mislukt. Geeft true als er een nieuwe catalogus klaarstaat.
+  bool stageCatalogUpdate(CatalogUpdate* update) {
+    refreshPending = false;
+    if (!update) return false;
+
     DatabaseService& db = DatabaseService::getInstance();
-    return db.postItemSelection(location, item.name, item.isDirty);
+    usingCachedData = db.isUsingCachedData();
+    dataSource = db.getDataSource();
+    dataFromDatabase = true;
+    if (update->kind == CatalogUpdate::UNCHANGED || update->items.empty()) return false;
+
+    staged = std::move(update->items);
+    hasStaged = true;
+    stagedAt = millis();
+    stagedFilterGeneration = requestedFilterGeneration;
+    return true;
+  }
+
+  // Nieuw bak filter van de API (UI thread). Geeft true als het anders is;
+  // de catalogus moet dan volledig opnieuw opgehaald worden (items die er
+  // bij komen staan niet in de huidige, gefilterde catalogus).
+  bool setBinFilter(BinFilter& filter) {
+    if (filter == binFilter) return false;
+    binFilter = std::move(filter);
+    filterGeneration++;
+    DatabaseService::getInstance().saveBinFilter(binFilter);
+    Serial.printf("Bin filter changed: trash bin %d, %u items\n", (int)binFilter.trashbinId,
+                  (unsigned)binFilter.itemIds.size());
+    return true;
+  }
+
+  bool isFilterOutdated() const { return catalogFilterGeneration != filterGeneration; }
+
+  // Sync afgebroken: de catalogus van de API past niet in RAM
+  void markTooLargeForRam() {
+    tooLargeForRam = true;
+    tooLargeFilterGeneration = requestedFilterGeneration;
+  }
+
+  bool hasStagedCatalog() const { return hasStaged; }
+
+  // RCU-achtige wissel op een veilig punt in de loop (tussen scheduler
+  // taken, niet tijdens render). Lezers vragen hun views steeds opnieuw op
+  // en zien dus de oude of de nieuwe catalogus, nooit een halve. De oude
+  // buffers worden pas na de wissel vrijgegeven.
+  void publishStagedCatalog() {
+    if (!hasStaged) return;
+    uint32_t start = micros();
+    std::swap(catalog, staged);
+    catalogFilterGeneration = stagedFilterGeneration;
+    version++;
+    uint32_t swapUs = micros() - start;
+    staged.clear();
+    hasStaged = false;
+
+    uint32_t waitMs = millis() - stagedAt;
+    swaps++;
+    lastSwapUs = swapUs;
+    if (swapUs > maxSwapUs) maxSwapUs = swapUs;
+    lastSwapWaitMs = waitMs;
+    Serial.printf("Catalog v%u live: %d items from %s (swap %lu us, waited %lu ms)\n",
+                  (unsigned)catalog.getDataVersion(), catalog.size(), dataSource.c_str(),
+                  (unsigned long)swapUs, (unsigned long)waitMs);
+  }
+
+  void printSyncStats(Print& out) const {
+    out.printf("Catalog v%u (%d items, %s), source %s%s\n",
+               (unsigned)catalog.getDataVersion(), catalog.size(), catalog.storageName(),
+               dataSource.c_str(), refreshPending ? ", sync pending" : "");
+    out.printf("  swaps %u, last %lu us (max %lu us), last wait %lu ms%s\n",
+               (unsigned)swaps, (unsigned long)lastSwapUs, (unsigned long)maxSwapUs,
+               (unsigned long)lastSwapWaitMs, hasStaged ? ", staged" : "");
+    if (tooLargeForRam) {
+      out.printf("  API catalog too large for RAM%s\n",
+                 catalog.isInPlace() ? ", periodic sync paused (flash catalog)" : "");
+    }
+    if (binFilter.active()) {
+      out.printf("  bin filter: trash bin %d at %s, %u items%s\n", (int)binFilter.trashbinId,
+                 DEVICE_LOCATION, (unsigned)binFilter.itemIds.size(),
+                 isFilterOutdated() ? " (catalog outdated)" : "");
+    }
+  }
+
+  // Post item selection to database (via network task outbox, non-blocking)
+  bool postItemSelection(const String& location, const Item& item, bool dirty) {
+    NetworkService& net = NetworkService::getInstance();
+    return net.enqueueSelection(location.c_str(), nameOf(item), dirty);
   }
   
-  // Refresh data from database
+  // Refresh data from database (op de netwerk taak; resultaat via
+  // stageCatalogUpdate). Met een bekende versie komt alleen een delta, die
+  // de netwerk taak met de huidige catalogus samenvoegt: daarom maximaal
+  // één sync tegelijk en geen nieuwe zolang er nog een wissel klaarstaat.
+  // Na een nieuw bak filter is de huidige catalogus geen goede basis meer.
+  // Een flash catalogus heeft geen versie en krijgt dus altijd een volledige
+  // sync; paste die niet, dan pas weer na een ander bak filter (misschien
+  // kleiner) of een reboot (nieuwe partitie).
   bool refreshFromDatabase() {
-    return loadFromDatabase();
+    if (refreshPending || hasStaged) return false;
+    if (tooLargeForRam && catalog.isInPlace() && tooLargeFilterGeneration == filterGeneration) {
+      return false;
+    }
+    const Catalog* base = catalog.getDataVersion() && !isFilterOutdated() ? &catalog : nullptr;
+    refreshPending = NetworkService::getInstance().enqueueCatalogFetch(base, &binFilter);
+    if (refreshPending) requestedFilterGeneration = filterGeneration;
+    return refreshPending;
   }
   
   // Status getters
@@ -218,8 +412,10 @@ public:
   bool isUsingCachedData() const { return usingCachedData; }
   String getDataSource() const { return dataSource; }
 
+  uint32_t getVersion() const { return version; }
+
   int getItemCount() const {
-    return items.size();
+    return catalog.size();
   }
 };
 
@@ -0,0 +1,167 @@
+#ifndef ITEM_SEARCH_H
+#define ITEM_SEARCH_H
+
+#include "Catalog.h"
+#include "../config.h"
+#include <vector>
+
+// Incrementeel zoeken op woord-prefix via de zoek index van de Catalog.
+// Resultaten zijn slots in catalogus volgorde (A-Z), zonder dubbelen.
+// Levert de prefix zoektocht niets op, dan volgt een tikfout-tolerante
+// zoektocht (trigrammen + begrensde edit distance), gerangschikt op
+// afstand. Buffers worden hergebruikt: na de eerste zoekopdracht geen
+// allocaties.
+class ItemSearch {
+public:
+  static const size_t FUZZY_MIN_LENGTH = 3;
+  static const size_t FUZZY_MAX_CANDIDATES = 48;  // Alleen deze krijgen een edit distance
+
+private:
+  std::vector<uint32_t> hitMask;   // 1 bit per slot
+  std::vector<uint16_t> results;
+  bool fuzzy = false;
+
+  // Fuzzy scratch
+  std::vector<uint8_t> shared;     // Gedeelde trigrammen per slot
+  std::vector<uint16_t> touched;   // Slots met shared > 0
+
+  struct Candidate {
+    uint16_t slot;
+    uint8_t shared;
+    uint8_t distance;
+  };
+  std::vector<Candidate> candidates;
+
+  static uint8_t maxDistanceFor(size_t length) {
+    return length <= 4 ? 1 : (length <= 8 ? 2 : 3);
+  }
+
+  // Kleinste edit distance tussen pattern en een willekeurig stuk van
+  // text (Sellers). Stopt bij > maxDistance; geeft dan maxDistance + 1.
+  static uint8_t substringDistance(const char* pattern, size_t m, const char* text,
+                                   uint8_t maxDistance) {
+    uint8_t column[32];
+    if (m >= sizeof(column)) m = sizeof(column) - 1;
+    for (size_t i = 0; i <= m; i++) column[i] = i;
+
+    uint8_t best = column[m];
+    for (const char* t = text; *t; t++) {
+      uint8_t diagonal = 0;  // Begin van een match mag overal: rij 0 blijft 0
+      for (size_t i = 1; i <= m; i++) {
+        uint8_t up = column[i];
+        uint8_t cost = pattern[i - 1] == *t ? 0 : 1;
+        uint8_t value = diagonal + cost;
+        if (up + 1 < value) value = up + 1;
+        if (column[i - 1] + 1 < value) value = column[i - 1] + 1;
+        diagonal = up;
+        column[i] = value;
+      }
+      if (column[m] < best) best = column[m];
+      if (best == 0) break;
+    }
+    return best > maxDistance ? maxDistance + 1 : best;
+  }
+
+  size_t runPrefix(const Catalog& source, const char* folded) {
+    size_t words = (source.size() + 31) / 32;
+    hitMask.assign(words, 0);
+    source.forEachPrefixMatch(folded, [this](uint16_t slot) {
+      hitMask[slot >> 5] |= 1u << (slot & 31);
+    });
+
+    // Bitmap uitlezen geeft meteen A-Z volgorde en ontdubbelt
+    for (size_t w = 0; w < words; w++) {
+      uint32_t bits = hitMask[w];
+      while (bits) {
+        results.push_back(w * 32 + __builtin_ctz(bits));
+        bits &= bits - 1;
+      }
+    }
+    return results.size();
+  }
+
+  size_t runFuzzy(const Catalog& source, const char* folded, size_t length) {
+    const TrigramIndex& index = source.getTrigramIndex();
+    if (index.empty()) return 0;
+
+    // Stap 1: gedeelde trigrammen tellen
+    shared.assign(source.size(), 0);
+    touched.clear();
+    uint8_t queryTrigrams = 0;
+    TrigramIndex::forEachTrigram(folded, [&](uint16_t key) {
+      if (queryTrigrams < 255) queryTrigrams++;
+      index.forEachPosting(key, [this](uint16_t slot) {
+        if (shared[slot] == 0) touched.push_back(slot);
+        if (shared[slot] < 255) shared[slot]++;
+      });
+    });
+
+    // Stap 2: beste kandidaten op trigram score
+    uint8_t minShared = queryTrigrams / 3 > 0 ? queryTrigrams / 3 : 1;
+    candidates.clear();
+    for (uint16_t slot : touched) {
+      if (shared[slot] >= minShared) candidates.push_back({slot, shared[slot], 0});
+    }
+    if (candidates.size() > FUZZY_MAX_CANDIDATES) {
+      std::partial_sort(candidates.begin(), candidates.begin() + FUZZY_MAX_CANDIDATES,
+                        candidates.end(), [](const Candidate& a, const Candidate& b) {
+        return a.shared > b.shared;
+      });
+      candidates.resize(FUZZY_MAX_CANDIDATES);
+    }
+
+    // Stap 3: begrensde edit distance, rangschikken, top-K
+    uint8_t maxDistance = maxDistanceFor(length);
+    size_t kept = 0;
+    for (const Candidate& c : candidates) {
+      uint8_t d = substringDistance(folded, length, source.foldedNameOf(c.slot), maxDistance);
+      if (d > maxDistance) continue;
+      candidates[kept] = c;
+      candidates[kept].distance = d;
+      kept++;
+    }
+    candidates.resize(kept);
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+      if (a.distance != b.distance) return a.distance < b.distance;
+      if (a.shared != b.shared) return a.shared > b.shared;
+      return a.slot < b.slot;
+    });
+
+    for (size_t i = 0; i < candidates.size() && i < FUZZY_TOP_K; i++) {
+      results.push_back(candidates[i].slot);
+    }
+    fuzzy = !results.empty();
+    return results.size();
+  }
+
+public:
+  // Geeft het aantal treffers terug; lege query = geen treffers
+  size_t run(const Catalog& source, const char* query) {
+    results.clear();
+    fuzzy = false;
+
+    char folded[32];
+    size_t length = TextFold::fold(query, folded, sizeof(folded));
+    if (length == 0) return 0;
+
+    if (runPrefix(source, folded) > 0) return results.size();
+    if (length < FUZZY_MIN_LENGTH) return 0;
+    return runFuzzy(source, folded, length);
+  }
+
+  void clear() {
+    results.clear();
+    fuzzy = false;
+  }
+
+  size_t size() const { return results.size(); }
+  bool empty() const { return results.empty(); }
+
+  // True als de treffers uit de tikfout-tolerante zoektocht komen
+  bool isFuzzy() const { return fuzzy; }
+
+  // Slot in de catalogus van treffer i
+  uint16_t slotAt(size_t i) const { return results[i]; }
+};
+
+#endif
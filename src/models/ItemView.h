@@ -0,0 +1,119 @@
+#ifndef ITEM_VIEW_H
+#define ITEM_VIEW_H
+
+#include "Item.h"
+#include <cstddef>
+#include <cstdint>
+
+// Read-only views op de ene, gezaghebbende catalogus in ItemRepository.
+// Views kopiëren geen items; ze zijn geldig tot de catalogus wordt
+// vervangen (zie ItemRepository::getVersion()).
+
+// Aaneengesloten range (bijv. de hele gesorteerde catalogus of één pagina)
+class ItemSpan {
+private:
+  const Item* first = nullptr;
+  size_t count = 0;
+
+public:
+  ItemSpan() {}
+  ItemSpan(const Item* f, size_t n) : first(f), count(n) {}
+
+  const Item* begin() const { return first; }
+  const Item* end() const { return first + count; }
+  size_t size() const { return count; }
+  bool empty() const { return count == 0; }
+  const Item& operator[](size_t i) const { return first[i]; }
+
+  // Deel-range, geklemd op de grenzen (bijv. één grid pagina)
+  ItemSpan subspan(size_t offset, size_t length) const {
+    if (offset >= count) return ItemSpan();
+    if (length > count - offset) length = count - offset;
+    return ItemSpan(first + offset, length);
+  }
+};
+
+// Items via een index tabel (slot nummers), bijv. alle items van één
+// categorie. De slots wijzen in de gesorteerde catalogus.
+class IndexedItemRange {
+private:
+  const Item* items = nullptr;
+  const uint16_t* slots = nullptr;
+  size_t count = 0;
+
+public:
+  class iterator {
+  private:
+    const Item* items;
+    const uint16_t* slot;
+
+  public:
+    iterator(const Item* i, const uint16_t* s) : items(i), slot(s) {}
+
+    const Item& operator*() const { return items[*slot]; }
+    const Item* operator->() const { return &items[*slot]; }
+    iterator& operator++() { ++slot; return *this; }
+    bool operator!=(const iterator& other) const { return slot != other.slot; }
+    bool operator==(const iterator& other) const { return slot == other.slot; }
+  };
+
+  IndexedItemRange() {}
+  IndexedItemRange(const Item* i, const uint16_t* s, size_t n) : items(i), slots(s), count(n) {}
+
+  iterator begin() const { return iterator(items, slots); }
+  iterator end() const { return iterator(items, slots + count); }
+  size_t size() const { return count; }
+  bool empty() const { return count == 0; }
+  const Item& operator[](size_t i) const { return items[slots[i]]; }
+};
+
+// Lazy gefilterde range: itereert over een span en slaat items over die
+// niet aan het predicaat voldoen. Geen allocatie, geen kopie.
+template <typename Predicate>
+class FilteredItemRange {
+private:
+  ItemSpan source;
+  Predicate predicate;
+
+public:
+  class iterator {
+  private:
+    const Item* current;
+    const Item* last;
+    const Predicate* predicate;
+
+    void skip() {
+      while (current != last && !(*predicate)(*current)) ++current;
+    }
+
+  public:
+    iterator(const Item* c, const Item* l, const Predicate* p)
+      : current(c), last(l), predicate(p) { skip(); }
+
+    const Item& operator*() const { return *current; }
+    const Item* operator->() const { return current; }
+    iterator& operator++() { ++current; skip(); return *this; }
+    bool operator!=(const iterator& other) const { return current != other.current; }
+    bool operator==(const iterator& other) const { return current == other.current; }
+  };
+
+  FilteredItemRange(ItemSpan s, Predicate p) : source(s), predicate(p) {}
+
+  iterator begin() const { return iterator(source.begin(), source.end(), &predicate); }
+  iterator end() const { return iterator(source.end(), source.end(), &predicate); }
+
+  bool empty() const { return !(begin() != end()); }
+
+  size_t count() const {
+    size_t n = 0;
+    for (auto it = begin(); it != end(); ++it) n++;
+    return n;
+  }
+};
+
+template <typename Predicate>
+FilteredItemRange<Predicate> filterItems(ItemSpan source, Predicate predicate) {
+  return FilteredItemRange<Predicate>(source, predicate);
+}
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef STRING_ARENA_H
+#define STRING_ARENA_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Eén aaneengesloten blok met NUL-terminated strings. Items verwijzen met
+// een offset; dubbele strings (zoals "Groen bak") worden bij het bouwen
+// maar één keer opgeslagen.
+class StringArena {
+private:
+  std::vector<char> data;
+  std::vector<uint32_t> internTable;  // Open addressing, alleen tijdens bouwen
+  uint32_t internCount = 0;
+  uint32_t bytesSaved = 0;
+
+  enum : uint32_t { EMPTY_SLOT = UINT32_MAX };
+
+  static uint32_t hash(const char* s) {
+    uint32_t h = 2166136261u;  // FNV-1a
+    while (*s) {
+      h ^= (uint8_t)*s++;
+      h *= 16777619u;
+    }
+    return h;
+  }
+
+  void growInternTable() {
+    std::vector<uint32_t> old;
+    old.swap(internTable);
+    internTable.assign(old.empty() ? 64 : old.size() * 2, EMPTY_SLOT);
+    for (uint32_t offset : old) {
+      if (offset == EMPTY_SLOT) continue;
+      uint32_t mask = internTable.size() - 1;
+      uint32_t i = hash(&data[offset]) & mask;
+      while (internTable[i] != EMPTY_SLOT) i = (i + 1) & mask;
+      internTable[i] = offset;
+    }
+  }
+
+public:
+  StringArena() {
+    data.push_back('\0');  // Offset 0 = lege string
+  }
+
+  // Altijd toevoegen (bijv. unieke namen)
+  uint32_t add(const char* s) {
+    uint32_t offset = data.size();
+    data.insert(data.end(), s, s + strlen(s) + 1);
+    return offset;
+  }
+
+  // Toevoegen met deduplicatie
+  uint32_t intern(const char* s) {
+    if (*s == '\0') return 0;
+    if ((internCount + 1) * 4 > internTable.size() * 3) {
+      growInternTable();
+    }
+
+    uint32_t mask = internTable.size() - 1;
+    uint32_t i = hash(s) & mask;
+    while (internTable[i] != EMPTY_SLOT) {
+      if (strcmp(&data[internTable[i]], s) == 0) {
+        bytesSaved += strlen(s) + 1;
+        return internTable[i];
+      }
+      i = (i + 1) & mask;
+    }
+
+    uint32_t offset = add(s);
+    internTable[i] = offset;
+    internCount++;
+    return offset;
+  }
+
+  void reserve(size_t bytes) { data.reserve(bytes); }
+
+  // Na het bouwen: hash tabel vrijgeven en arena op maat maken
+  void finalize() {
+    std::vector<uint32_t>().swap(internTable);
+    internCount = 0;
+    data.shrink_to_fit();
+  }
+
+  void clear() {
+    data.assign(1, '\0');
+    std::vector<uint32_t>().swap(internTable);
+    internCount = 0;
+    bytesSaved = 0;
+  }
+
+  const char* at(uint32_t offset) const { return &data[offset]; }
+  const char* base() const { return data.data(); }
+  size_t size() const { return data.size(); }
+  size_t capacity() const { return data.capacity(); }
+  uint32_t getBytesSaved() const { return bytesSaved; }
+};
+
+#endif
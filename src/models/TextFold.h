@@ -0,0 +1,58 @@
+#ifndef TEXT_FOLD_H
+#define TEXT_FOLD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cctype>
+
+// Normaliseert tekst voor zoeken: kleine letters, accenten weg
+// ("Crème" -> "creme"), alles behalve letters/cijfers wordt één spatie
+// ("Doos (Karton)" -> "doos karton"). Alleen Latin-1 (UTF-8 C3 xx) wordt
+// omgezet; overige multibyte tekens gelden als scheidingsteken.
+namespace TextFold {
+
+// U+00C0..U+00FF -> ASCII basisletter, ' ' = scheidingsteken (x, ÷)
+static const char LATIN1_BASE[65] =
+  "aaaaaaaceeeeiiiidnooooo ouuuuyts"   // À..ß
+  "aaaaaaaceeeeiiiidnooooo ouuuuyty";  // à..ÿ
+
+// Schrijft de gevouwen tekst naar out (altijd NUL-terminated) en geeft de
+// lengte terug. Geen spatie aan begin of eind.
+inline size_t fold(const char* in, char* out, size_t outSize) {
+  if (outSize == 0) return 0;
+  size_t len = 0;
+  bool pendingSpace = false;
+  const uint8_t* p = (const uint8_t*)in;
+
+  while (*p && len + 1 < outSize) {
+    char c = 0;
+    if (*p < 0x80) {
+      if (isalnum(*p)) c = tolower(*p);
+      p++;
+    } else if (*p == 0xC3 && p[1] >= 0x80 && p[1] <= 0xBF) {
+      c = LATIN1_BASE[p[1] - 0x80];
+      if (c == ' ') c = 0;
+      p += 2;
+    } else {
+      p++;
+      while ((*p & 0xC0) == 0x80) p++;  // Rest van de UTF-8 reeks overslaan
+    }
+
+    if (c == 0) {
+      pendingSpace = len > 0;
+      continue;
+    }
+    if (pendingSpace) {
+      if (len + 2 >= outSize) break;
+      out[len++] = ' ';
+      pendingSpace = false;
+    }
+    out[len++] = c;
+  }
+  out[len] = '\0';
+  return len;
+}
+
+}  // namespace TextFold
+
+#endif
@@ -0,0 +1,197 @@
+#ifndef TRIGRAM_INDEX_H
+#define TRIGRAM_INDEX_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+
+// Compacte trigram posting index over gevouwen namen (zie TextFold).
+// Trigrammen worden gecodeerd in 16 bits (37 symbolen: spatie, a-z, 0-9);
+// per trigram een lijst met slots. Namen worden met een spatie aan beide
+// kanten gepad, zodat woordgrenzen meetellen.
+//
+// Past de index niet in het budget, dan worden de langste posting lijsten
+// ingekort (tot de eerste N slots, A-Z). Zo blijft elk trigram vindbaar
+// en verliest alleen een heel veel voorkomend trigram een deel van zijn
+// items. Past het dan nog niet, dan vallen trigrammen af.
+//
+// Zoeken gaat via pointers, zodat een index uit een binair snapshot
+// (flash of RAM) zonder kopie bruikbaar is (attach).
+class TrigramIndex {
+public:
+  static const uint8_t SYMBOLS = 37;
+
+private:
+  // Eigen opslag (na build)
+  std::vector<uint16_t> keys;      // Gesorteerde unieke trigrammen
+  std::vector<uint32_t> starts;    // keys.size() + 1 offsets in postings
+  std::vector<uint16_t> postings;  // Slots, oplopend per trigram
+
+  // Actieve index: eigen opslag of een snapshot
+  const uint16_t* keyData = nullptr;
+  const uint32_t* startData = nullptr;
+  const uint16_t* postingData = nullptr;
+  uint32_t keyCount = 0;
+  uint32_t postingTotal = 0;
+
+  uint32_t droppedTrigrams = 0;
+  uint32_t truncatedLists = 0;
+  uint32_t listCap = 0;            // 0 = geen limiet
+
+  static size_t bytesFor(size_t keyCount, size_t postingCount) {
+    return keyCount * (sizeof(uint16_t) + sizeof(uint32_t)) + sizeof(uint32_t)
+         + postingCount * sizeof(uint16_t);
+  }
+
+public:
+  static uint8_t symbol(char c) {
+    if (c >= 'a' && c <= 'z') return 1 + (c - 'a');
+    if (c >= '0' && c <= '9') return 27 + (c - '0');
+    return 0;
+  }
+
+  // Roept onTrigram(key) aan voor elk trigram van " text " (text gevouwen)
+  template <typename F>
+  static void forEachTrigram(const char* text, F onTrigram) {
+    size_t len = strlen(text);
+    if (len == 0) return;
+    uint8_t a = 0;                // Padding spatie
+    uint8_t b = symbol(text[0]);
+    for (size_t i = 1; i <= len; i++) {
+      uint8_t c = i < len ? symbol(text[i]) : 0;
+      onTrigram((uint16_t)((a * SYMBOLS + b) * SYMBOLS + c));
+      a = b;
+      b = c;
+    }
+  }
+
+  // nameAt(slot) geeft de gevouwen naam; budget 0 = onbeperkt
+  template <typename F>
+  void build(size_t itemCount, F nameAt, size_t budgetBytes) {
+    clear();
+
+    // (trigram << 16 | slot) paren; sorteren groepeert per trigram en
+    // maakt dubbele trigrammen binnen één naam zichtbaar
+    std::vector<uint32_t> pairs;
+    for (size_t slot = 0; slot < itemCount; slot++) {
+      forEachTrigram(nameAt(slot), [&pairs, slot](uint16_t key) {
+        pairs.push_back(((uint32_t)key << 16) | slot);
+      });
+    }
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+    // Groepen: [begin, end) in pairs per trigram
+    std::vector<uint32_t> groupStart;
+    for (size_t i = 0; i < pairs.size(); i++) {
+      if (i == 0 || (pairs[i] >> 16) != (pairs[i - 1] >> 16)) groupStart.push_back(i);
+    }
+    size_t groups = groupStart.size();
+    groupStart.push_back(pairs.size());
+
+    // Budget: grootste lijst lengte zoeken die past (binair zoeken)
+    auto postingsWithCap = [&groupStart, groups](size_t cap) {
+      size_t total = 0;
+      for (size_t g = 0; g < groups; g++) {
+        size_t len = groupStart[g + 1] - groupStart[g];
+        total += len < cap ? len : cap;
+      }
+      return total;
+    };
+    size_t cap = pairs.size();
+    size_t keptKeys = groups;
+    if (budgetBytes > 0 && bytesFor(groups, pairs.size()) > budgetBytes) {
+      size_t lo = 1, hi = pairs.size();
+      while (lo < hi) {
+        size_t mid = (lo + hi + 1) / 2;
+        if (bytesFor(groups, postingsWithCap(mid)) <= budgetBytes) lo = mid; else hi = mid - 1;
+      }
+      cap = lo;
+      listCap = cap;
+      if (bytesFor(groups, postingsWithCap(cap)) > budgetBytes) {
+        // Zelfs 1 slot per trigram past niet: staart laten vallen
+        while (keptKeys > 0 && bytesFor(keptKeys, keptKeys) > budgetBytes) keptKeys--;
+      }
+      droppedTrigrams = groups - keptKeys;
+    }
+
+    keys.reserve(keptKeys);
+    starts.reserve(keptKeys + 1);
+    postings.reserve(postingsWithCap(cap));
+    for (size_t g = 0; g < keptKeys; g++) {
+      keys.push_back(pairs[groupStart[g]] >> 16);
+      starts.push_back(postings.size());
+      size_t end = groupStart[g + 1];
+      if (end - groupStart[g] > cap) {
+        end = groupStart[g] + cap;
+        truncatedLists++;
+      }
+      for (size_t i = groupStart[g]; i < end; i++) {
+        postings.push_back(pairs[i] & 0xFFFF);
+      }
+    }
+    starts.push_back(postings.size());
+    attach(keys.data(), keys.size(), starts.data(), postings.data(), postings.size(), listCap);
+  }
+
+  // Gebruik een bestaande index (bijv. uit een snapshot); niet gekopieerd
+  void attach(const uint16_t* keyArray, uint32_t keyArrayCount, const uint32_t* startArray,
+              const uint16_t* postingArray, uint32_t postingArrayCount, uint32_t cap) {
+    keyData = keyArray;
+    keyCount = keyArrayCount;
+    startData = startArray;
+    postingData = postingArray;
+    postingTotal = postingArrayCount;
+    listCap = cap;
+  }
+
+  void clear() {
+    std::vector<uint16_t>().swap(keys);
+    std::vector<uint32_t>().swap(starts);
+    std::vector<uint16_t>().swap(postings);
+    keyData = nullptr;
+    startData = nullptr;
+    postingData = nullptr;
+    keyCount = 0;
+    postingTotal = 0;
+    droppedTrigrams = 0;
+    truncatedLists = 0;
+    listCap = 0;
+  }
+
+  // Roept onSlot(slot) aan voor elk item met dit trigram
+  template <typename F>
+  void forEachPosting(uint16_t key, F onSlot) const {
+    const uint16_t* end = keyData + keyCount;
+    const uint16_t* it = std::lower_bound(keyData, end, key);
+    if (it == end || *it != key) return;
+    size_t k = it - keyData;
+    for (uint32_t i = startData[k]; i < startData[k + 1]; i++) onSlot(postingData[i]);
+  }
+
+  bool empty() const { return keyCount == 0; }
+  size_t trigramCount() const { return keyCount; }
+  size_t postingCount() const { return postingTotal; }
+
+  const uint16_t* getKeys() const { return keyData; }
+  const uint32_t* getStarts() const { return startData; }
+  const uint16_t* getPostings() const { return postingData; }
+  uint32_t getDroppedTrigrams() const { return droppedTrigrams; }
+  uint32_t getTruncatedLists() const { return truncatedLists; }
+  uint32_t getListCap() const { return listCap; }
+  // Grootte van de index, ongeacht waar hij staat
+  size_t memoryUsage() const {
+    if (!startData) return 0;
+    return keyCount * sizeof(uint16_t) + (keyCount + 1) * sizeof(uint32_t)
+         + postingTotal * sizeof(uint16_t);
+  }
+
+  // Alleen wat deze index zelf op de heap heeft
+  size_t heapBytes() const {
+    return keys.capacity() * sizeof(uint16_t) + starts.capacity() * sizeof(uint32_t)
+         + postings.capacity() * sizeof(uint16_t);
+  }
+};
+
+#endif
@@ -0,0 +1,345 @@
+#ifndef API_CLIENT_H
+#define API_CLIENT_H
+
+#include <Arduino.h>
+#include <WiFiClient.h>
+#include "../config.h"
+
+// Eén blijvende HTTP/1.1 verbinding (keep-alive) met API_HOST:API_PORT,
+// alleen voor de netwerk taak. Het request wordt in een vaste buffer
+// opgebouwd (geen String concatenaties); path segmenten worden
+// percent-encoded ("Doos (Karton)" -> "Doos%20%28Karton%29").
+//
+//   api.request("POST", "/sentData").segment(location).segment(item);
+//   int code = api.send(5000);
+//   deserializeJson(doc, api.body());
+//   api.end();
+//
+// Na end() blijft de verbinding open als de server dat toestaat en de body
+// helemaal gelezen is; het volgende request slaat dan de TCP handshake over.
+class ApiClient {
+public:
+  struct Stats {
+    uint32_t requests = 0;
+    uint32_t reused = 0;       // Over een bestaande verbinding
+    uint32_t connects = 0;     // Nieuwe TCP verbindingen
+    uint32_t retries = 0;      // Verbinding bleek dicht, opnieuw op een nieuwe
+    uint32_t failures = 0;     // Geen HTTP antwoord
+    uint32_t lastMs = 0;       // Request tot en met de headers
+    uint32_t maxMs = 0;
+    uint64_t totalMs = 0;
+
+    uint32_t avgMs() const { return requests ? (uint32_t)(totalMs / requests) : 0; }
+    float reuseRate() const { return requests ? 100.0f * reused / requests : 0.0f; }
+  };
+
+  // Body van het huidige antwoord: leest hooguit Content-Length bytes, zodat
+  // een parser nooit in het volgende antwoord (of op de timeout) belandt
+  class BodyStream : public Stream {
+  private:
+    WiFiClient& socket;
+    int32_t remaining = 0;   // -1 = onbekend, lezen tot de server sluit
+
+  public:
+    explicit BodyStream(WiFiClient& client) : socket(client) {}
+
+    void reset(int32_t length) { remaining = length; }
+    int32_t left() const { return remaining; }
+
+    int available() override {
+      if (remaining == 0) return 0;
+      int n = socket.available();
+      return (remaining > 0 && n > remaining) ? remaining : n;
+    }
+    int read() override {
+      if (remaining == 0) return -1;
+      int c = socket.read();
+      if (c >= 0 && remaining > 0) remaining--;
+      return c;
+    }
+    int peek() override { return remaining == 0 ? -1 : socket.peek(); }
+    size_t write(uint8_t) override { return 0; }
+    using Print::write;
+  };
+
+private:
+  WiFiClient socket;
+  BodyStream bodyStream;
+  char buffer[API_REQUEST_BUFFER];   // Request line, daarna headers
+  size_t length = 0;
+  bool overflow = false;
+  bool hasQuery = false;
+  bool isPost = false;
+  char extraHeaders[96];
+  size_t extraLength = 0;
+  int32_t contentLength = -1;
+  bool keepAlive = false;
+  bool responseStarted = false;   // Minstens één byte antwoord ontvangen
+  bool timedOut = false;          // readLine stopte op de deadline
+  Stats stats;
+
+  void append(const char* text, size_t n) {
+    if (length + n >= sizeof(buffer)) {
+      overflow = true;
+      return;
+    }
+    memcpy(buffer + length, text, n);
+    length += n;
+    buffer[length] = '\0';
+  }
+
+  void append(const char* text) { append(text, strlen(text)); }
+
+  void appendEncoded(const char* text) {
+    static const char hex[] = "0123456789ABCDEF";
+    for (const char* p = text; *p; p++) {
+      uint8_t c = (uint8_t)*p;
+      if (isalnum(c) || c == '-' || c == '.' || c == '_' || c == '~') {
+        append((const char*)&c, 1);
+      } else {
+        char escaped[3] = {'%', hex[c >> 4], hex[c & 0x0F]};
+        append(escaped, 3);
+      }
+    }
+  }
+
+  // Eén regel van de response headers (zonder \r\n); false bij timeout
+  // (timedOut) of als de verbinding dicht gaat
+  bool readLine(char* line, size_t size, uint32_t deadline) {
+    size_t n = 0;
+    while (true) {
+      int c = socket.read();
+      if (c < 0) {
+        if (!socket.connected() && socket.available() == 0) return false;
+        if ((int32_t)(millis() - deadline) > 0) {
+          timedOut = true;
+          return false;
+        }
+        delay(1);
+        continue;
+      }
+      responseStarted = true;
+      if (c == '\n') break;
+      if (c != '\r' && n + 1 < size) line[n++] = (char)c;
+    }
+    line[n] = '\0';
+    return true;
+  }
+
+  // Status code, of -1 als er geen antwoord kwam
+  int readResponseHead(uint32_t deadline) {
+    char line[96];
+    if (!readLine(line, sizeof(line), deadline)) return -1;
+    // "HTTP/1.1 200 OK"
+    const char* space = strchr(line, ' ');
+    if (strncmp(line, "HTTP/1.", 7) != 0 || !space) return -1;
+    int code = atoi(space + 1);
+    keepAlive = line[7] == '1';
+    contentLength = -1;
+
+    while (readLine(line, sizeof(line), deadline)) {
+      if (line[0] == '\0') {
+        // Zonder lengte weten we niet waar de body eindigt (of 304/204:
+        // nooit een body)
+        if (code == 204 || code == 304) contentLength = 0;
+        if (contentLength < 0) keepAlive = false;
+        bodyStream.reset(contentLength);
+        return code;
+      }
+      char* colon = strchr(line, ':');
+      if (!colon) continue;
+      *colon = '\0';
+      const char* value = colon + 1;
+      while (*value == ' ') value++;
+      if (strcasecmp(line, "Content-Length") == 0) {
+        contentLength = atol(value);
+      } else if (strcasecmp(line, "Connection") == 0) {
+        keepAlive = strcasecmp(value, "close") != 0;
+      } else if (strcasecmp(line, "Transfer-Encoding") == 0) {
+        // Chunked lezen we niet; de API stuurt altijd een Content-Length
+        contentLength = -1;
+      }
+    }
+    return -1;
+  }
+
+  bool connect(uint32_t timeoutMs) {
+    if (!socket.connect(API_HOST, API_PORT, timeoutMs)) return false;
+    socket.setNoDelay(true);  // Request gaat in één write; niet wachten op Nagle
+    stats.connects++;
+    return true;
+  }
+
+public:
+  ApiClient() : bodyStream(socket) {
+    buffer[0] = '\0';
+    extraHeaders[0] = '\0';
+  }
+
+  ApiClient(const ApiClient&) = delete;
+  void operator=(const ApiClient&) = delete;
+
+  // ========== Request opbouwen ==========
+
+  // Nieuw request; path is een vaste route zonder te encoderen tekens
+  ApiClient& request(const char* method, const char* path) {
+    length = 0;
+    overflow = false;
+    hasQuery = false;
+    isPost = strcmp(method, "POST") == 0;
+    extraLength = 0;
+    extraHeaders[0] = '\0';
+    append(method);
+    append(" ");
+    append(path);
+    return *this;
+  }
+
+  // "/" + percent-encoded tekst (locatie, item naam)
+  ApiClient& segment(const char* text) {
+    append("/");
+    appendEncoded(text);
+    return *this;
+  }
+
+  ApiClient& segment(long value) {
+    char number[12];
+    snprintf(number, sizeof(number), "/%ld", value);
+    append(number);
+    return *this;
+  }
+
+  ApiClient& query(const char* key, unsigned long value) {
+    char param[32];
+    snprintf(param, sizeof(param), "%c%s=%lu", hasQuery ? '&' : '?', key, value);
+    hasQuery = true;
+    append(param);
+    return *this;
+  }
+
+  ApiClient& header(const char* name, const char* value) {
+    int n = snprintf(extraHeaders + extraLength, sizeof(extraHeaders) - extraLength,
+                     "%s: %s\r\n", name, value);
+    if (n < 0 || extraLength + n >= sizeof(extraHeaders)) {
+      overflow = true;
+    } else {
+      extraLength += n;
+    }
+    return *this;
+  }
+
+  // Request line zoals hij verstuurd wordt (voor logging, vóór send())
+  const char* target() const { return buffer; }
+
+  // ========== Versturen ==========
+
+  // Verstuurt het request en leest status + headers. Geeft de HTTP status
+  // code, of een negatieve waarde als er geen antwoord kwam. De body staat
+  // daarna klaar in body(); altijd afsluiten met end(). Een POST body
+  // (JSON) gaat direct na de headers mee.
+  int send(uint32_t timeoutMs, const char* payload = nullptr, size_t payloadLength = 0) {
+    if (overflow) {
+      Serial.printf("API request too long: %s\n", buffer);
+      stats.failures++;
+      return -2;
+    }
+    uint32_t start = millis();
+    size_t lineLength = length;
+
+    // Request line + headers in de buffer, zodat alles in één write gaat
+    char tail[128];
+    snprintf(tail, sizeof(tail), " HTTP/1.1\r\nHost: %s:%d\r\n", API_HOST, API_PORT);
+    append(tail);
+    if (payloadLength > 0) {
+      snprintf(tail, sizeof(tail), "Content-Type: application/json\r\nContent-Length: %u\r\n",
+               (unsigned)payloadLength);
+      append(tail);
+    } else if (isPost) {
+      append("Content-Length: 0\r\n");
+    }
+    append(extraHeaders, extraLength);
+    append("\r\n");
+    if (overflow) {
+      buffer[lineLength] = '\0';
+      Serial.printf("API request too long: %s\n", buffer);
+      stats.failures++;
+      return -2;
+    }
+
+    stats.requests++;
+    // Een door de server gesloten (idle) verbinding ziet connected() al;
+    // dan eerst opnieuw verbinden
+    bool reused = socket.connected();
+    uint32_t deadline = start + timeoutMs;
+    int code = -1;
+    for (int attempt = 0; attempt < 2 && code < 0; attempt++) {
+      if (!reused && !connect(timeoutMs)) break;
+      responseStarted = false;
+      timedOut = false;
+      bool written = socket.write((const uint8_t*)buffer, length) == length &&
+                     (payloadLength == 0 ||
+                      socket.write((const uint8_t*)payload, payloadLength) == payloadLength);
+      if (written) code = readResponseHead(deadline);
+      if (code >= 0) break;
+      socket.stop();
+      // Alleen opnieuw als de server het request niet verwerkt heeft: een
+      // hergebruikte verbinding waarop het schrijven mislukte of die dicht
+      // ging vóór er één byte antwoord kwam. Bij een timeout kan een trage
+      // server de POST wel verwerkt hebben; nog eens sturen telt dubbel.
+      if (!reused || (written && (timedOut || responseStarted))) break;
+      reused = false;
+      stats.retries++;
+      deadline = millis() + timeoutMs;  // Nieuwe verbinding, eigen deadline
+    }
+    buffer[lineLength] = '\0';
+
+    uint32_t ms = millis() - start;
+    stats.lastMs = ms;
+    stats.totalMs += ms;
+    if (ms > stats.maxMs) stats.maxMs = ms;
+    if (code < 0) {
+      stats.failures++;
+      return code;
+    }
+    if (reused) stats.reused++;
+    bodyStream.setTimeout(timeoutMs);
+    return code;
+  }
+
+  Stream& body() { return bodyStream; }
+  int32_t bodyLength() const { return contentLength; }
+
+  // Klaar met het antwoord. Een kleine ongelezen rest wordt weggelezen
+  // zodat de verbinding bruikbaar blijft; anders gaat hij dicht.
+  void end() {
+    int32_t left = bodyStream.left();
+    if (keepAlive && left > 0 && left <= API_DRAIN_LIMIT) {
+      uint32_t deadline = millis() + 200;
+      while (bodyStream.left() > 0 && (int32_t)(millis() - deadline) < 0) {
+        if (bodyStream.read() < 0) delay(1);
+      }
+      left = bodyStream.left();
+    }
+    if (!keepAlive || left != 0) socket.stop();
+    bodyStream.reset(0);
+  }
+
+  // Bij WiFi verlies (NetworkJobType::CLOSE_CONNECTION): de oude socket
+  // is toch onbruikbaar
+  void close() {
+    socket.stop();
+    bodyStream.reset(0);
+  }
+
+  const Stats& getStats() const { return stats; }
+
+  void printStats(Print& out) const {
+    out.printf("api: %u requests, %u reused (%.0f%%), %u connects, %u retries, %u failed\n",
+               (unsigned)stats.requests, (unsigned)stats.reused, stats.reuseRate(),
+               (unsigned)stats.connects, (unsigned)stats.retries, (unsigned)stats.failures);
+    out.printf("api latency: last=%ums avg=%ums max=%ums\n",
+               (unsigned)stats.lastMs, (unsigned)stats.avgMs(), (unsigned)stats.maxMs);
+  }
+};
+
+#endif
@@ -2,19 +2,59 @@
 #define DATABASE_SERVICE_H
 
 #include <WiFi.h>
-#include <HTTPClient.h>
+#include <HTTPClient.h>  // HTTP_CODE_* constanten
 #include <ArduinoJson.h>
 #include <LittleFS.h>
 #include "../models/Item.h"
+#include "../models/Catalog.h"
 #include "../config.h"
+#include "../diagnostics/Tracer.h"
+#include "WiFiManager.h"
+#include "JsonStream.h"
+#include "ApiClient.h"
+#include "OutboxLog.h"
+#include "../diagnostics/HeapWatermark.h"
 #include <vector>
 
+// Resultaat van een catalogus sync (gemaakt op de netwerk taak, toegepast
+// op de UI thread door ItemRepository::stageCatalogUpdate)
+struct CatalogUpdate {
+    enum Kind : uint8_t {
+        FULL,       // items is de hele catalogus
+        DELTA,      // items = nieuw/gewijzigd sinds baseVersion, plus removed
+        UNCHANGED   // 304: niets veranderd sinds baseVersion
+    };
+    
+    Kind kind = FULL;
+    Catalog items;                 // Na mergeDelta altijd de hele catalogus
+    std::vector<int32_t> removed;  // DELTA: verwijderde ids
+    uint32_t baseVersion = 0;      // Versie waar de delta op voortbouwt
+    uint32_t version = 0;          // Versie van de server na deze sync
+    uint32_t bytes = 0;            // Body bytes over de lijn
+    uint32_t ms = 0;               // Request tot en met parse
+    bool tooLarge = false;         // Afgebroken: past niet in RAM
+};
+
+// Welke items in de bak op DEVICE_LOCATION mogen (/trashBinItems).
+// Geen bak of een lege lijst = geen filter: de hele catalogus.
+struct BinFilter {
+    int32_t trashbinId = 0;
+    std::vector<int32_t> itemIds;  // Gesorteerd
+
+    bool active() const { return !itemIds.empty(); }
+    bool operator==(const BinFilter& other) const {
+        return trashbinId == other.trashbinId && itemIds == other.itemIds;
+    }
+    bool operator!=(const BinFilter& other) const { return !(*this == other); }
+};
+
 class DatabaseService {
 private:
-    bool wifiConnected = false;
     bool usingCachedData = false;
     String lastUpdateTime = "never";
     String dataSource = "unknown";
+    ApiClient api;  // Eén keep-alive verbinding; alleen de netwerk taak gebruikt hem
+    OutboxRecord outboxBatch[PENDING_BATCH_SIZE];  // processPendingPosts (netwerk taak)
     
     // Singleton
     DatabaseService() {}
@@ -29,159 +69,285 @@ public:
     DatabaseService(const DatabaseService&) = delete;
     void operator=(const DatabaseService&) = delete;
     
-    // Initialize WiFi connection
-    bool connectWiFi(unsigned long timeoutMs = 10000) {
-        Serial.println("Connecting to WiFi...");
-        Serial.printf("SSID: %s\n", WIFI_SSID);
+    // Verbinding wordt beheerd door WiFiManager (reconnect met backoff)
+    bool isWiFiConnected() {
+        return WiFiManager::getInstance().isConnected();
+    }
+    
+    // Catalogus sync met de API (alleen netwerk; lokale snapshot is al
+    // geladen). Met sinceVersion > 0 vraagt de API alleen wat er sinds die
+    // versie veranderd is (of 304 als er niets veranderd is). Het antwoord
+    // wordt direct van de socket geparsed, één item per keer (zie
+    // JsonStream): geheugen blijft gelijk, ongeacht de catalogus.
+    bool fetchItems(CatalogUpdate& update, uint32_t sinceVersion) {
+        TRACE_SCOPE(TraceName::DB_FETCH_ITEMS);
+        if (!isWiFiConnected()) {
+            Serial.println("WiFi not connected, keeping local data");
+            return false;
+        }
+        
+        api.request("GET", "/items");
+        if (sinceVersion > 0) {
+            char etag[16];
+            snprintf(etag, sizeof(etag), "\"%lu\"", (unsigned long)sinceVersion);
+            api.query("since", sinceVersion).header("If-None-Match", etag);
+        }
         
-        WiFi.mode(WIFI_STA);
-        WiFi.begin(WIFI_SSID, WIFI_PASS);
+        Serial.printf("Fetching items: %s\n", api.target());
         
-        unsigned long startTime = millis();
-        while (WiFi.status() != WL_CONNECTED && millis() - startTime < timeoutMs) {
-            delay(500);
-            Serial.print(".");
+        uint32_t start = millis();
+        int httpCode = api.send(5000);  // 5 second timeout
+        
+        if (httpCode == HTTP_CODE_NOT_MODIFIED) {
+            api.end();
+            update.kind = CatalogUpdate::UNCHANGED;
+            update.baseVersion = sinceVersion;
+            update.version = sinceVersion;
+            update.ms = millis() - start;
+            Serial.printf("Catalog v%u unchanged (304, %lu ms)\n",
+                          (unsigned)sinceVersion, (unsigned long)update.ms);
+            return true;
+        }
+        if (httpCode != HTTP_CODE_OK) {
+            Serial.printf("HTTP error: %d\n", httpCode);
+            api.end();
+            return false;
         }
         
-        if (WiFi.status() == WL_CONNECTED) {
-            wifiConnected = true;
-            Serial.println("\nWiFi connected!");
-            Serial.printf("IP: %s\n", WiFi.localIP().toString().c_str());
+        HeapWatermark heap;
+        Catalog& items = update.items;
+        items.clear();
+        update.removed.clear();
+        update.kind = CatalogUpdate::FULL;
+        update.baseVersion = 0;
+        update.version = 0;
+        String source = "unknown";
+        String updated = "now";
+        bool itemsDone = false;
+        
+        // Eén element tegelijk; het document wordt per item hergebruikt
+        StaticJsonDocument<512> element;
+        bool tooLarge = false;
+        CountingStream body(api.body());
+        JsonStream json(body);
+        auto addItem = [&](JsonDocument& doc) {
+            // Groeiende buffers verdubbelen: stop ruim voordat de heap op is
+            // (een catalogus die niet in RAM past blijft in flash). De rest
+            // niet meer downloaden; de verbinding gaat dicht.
+            if ((items.size() & 63) == 0 &&
+                !HeapWatermark::fits(2 * items.heapBytes(), CATALOG_MIN_FREE_HEAP)) {
+                tooLarge = true;
+                json.abort();
+                return false;
+            }
+            addFetchedItem(items, doc);
+            heap.sample();
             return true;
+        };
+        char key[24];
+        while (json.nextKey(key, sizeof(key))) {
+            if (strcmp(key, "items") == 0) {
+                itemsDone = json.forEachElement(element, addItem);
+            } else if (strcmp(key, "changed") == 0) {
+                // Delta: nieuwe en gewijzigde items
+                update.kind = CatalogUpdate::DELTA;
+                itemsDone = json.forEachElement(element, addItem);
+            } else if (strcmp(key, "removed") == 0) {
+                // Delta: verwijderde items als {"id": n}
+                if (!json.forEachElement(element, [&](JsonDocument& doc) {
+                    update.removed.push_back(doc["id"] | 0);
+                    return true;
+                })) break;
+            } else if (strcmp(key, "version") == 0 || strcmp(key, "since") == 0) {
+                StaticJsonDocument<16> value;
+                if (!json.readValue(value)) break;
+                (key[0] == 'v' ? update.version : update.baseVersion) = value.as<uint32_t>();
+            } else if (strcmp(key, "source") == 0) {
+                readText(json, source);
+            } else if (strcmp(key, "last_updated") == 0) {
+                readText(json, updated);
+            } else {
+                json.skipValue();
+            }
+        }
+        if (tooLarge) {
+            api.close();
+        } else {
+            api.end();
         }
+        update.bytes = body.bytesRead();
+        update.ms = millis() - start;
         
-        Serial.println("\nWiFi connection failed!");
-        wifiConnected = false;
-        return false;
+        if (tooLarge) {
+            Serial.printf("Catalog too large for RAM after %d items (%u bytes read), keeping local data\n",
+                          items.size(), (unsigned)update.bytes);
+            items.clear();
+            update.tooLarge = true;
+            return false;
+        }
+        // Een fout na de items (bijv. een afgebroken verbinding aan het
+        // eind) kost ons niets; een fout in de items of removed wel
+        if (!itemsDone || (!json.ok() && update.kind == CatalogUpdate::DELTA)) {
+            Serial.println("Items stream incomplete, keeping local data");
+            items.clear();
+            return false;
+        }
+        items.finalize();
+        items.setDataVersion(update.version);
+        heap.sample();
+        
+        // Check source (database or cache from server)
+        dataSource = source;
+        lastUpdateTime = updated;
+        usingCachedData = (dataSource == "cache");
+        
+        Serial.printf("Data source: %s\n", dataSource.c_str());
+        if (usingCachedData) {
+            Serial.printf("Server using cached data from: %s\n", lastUpdateTime.c_str());
+        }
+        if (update.kind == CatalogUpdate::DELTA) {
+            Serial.printf("Catalog delta v%u -> v%u: %d changed, %u removed, %u bytes in %lu ms\n",
+                          (unsigned)update.baseVersion, (unsigned)update.version, items.size(),
+                          (unsigned)update.removed.size(), (unsigned)update.bytes,
+                          (unsigned long)update.ms);
+        } else {
+            Serial.printf("Fetched %d items (v%u) from API: %u bytes in %lu ms\n",
+                          items.size(), (unsigned)update.version, (unsigned)update.bytes,
+                          (unsigned long)update.ms);
+        }
+        Serial.printf("Fetch peak heap +%u bytes (min free %u)\n",
+                      (unsigned)heap.peakUsed(), (unsigned)heap.minFree());
+        
+        return true;
     }
     
-    bool isWiFiConnected() {
-        wifiConnected = (WiFi.status() == WL_CONNECTED);
-        return wifiConnected;
+    // Delta samenvoegen met de huidige catalogus (netwerk taak). base wordt
+    // alleen gelezen; het resultaat komt in een nieuwe buffer, zodat de UI
+    // straks alleen hoeft te wisselen. Alleen de gewijzigde items worden
+    // gesorteerd en in de bestaande volgorde gemerged.
+    bool mergeDelta(CatalogUpdate& update, const Catalog& base) {
+        if (update.kind != CatalogUpdate::DELTA) return true;
+        if (base.getDataVersion() != update.baseVersion) {
+            Serial.printf("Catalog delta for v%u ignored (local v%u)\n",
+                          (unsigned)update.baseVersion, (unsigned)base.getDataVersion());
+            return false;
+        }
+        // Samengevoegd staat de hele catalogus in RAM, ook als base in flash staat
+        if (!HeapWatermark::fits(2 * base.memoryUsage(), CATALOG_MIN_FREE_HEAP)) {
+            Serial.printf("Catalog v%u too large to merge in RAM, keeping local data\n",
+                          (unsigned)base.getDataVersion());
+            return false;
+        }
+        uint32_t start = micros();
+        Catalog merged;
+        merged.mergeFrom(base, update.items, update.removed);
+        merged.setDataVersion(update.version);
+        Serial.printf("Catalog merged to v%u: %d items (+%d/-%u) in %lu us\n",
+                      (unsigned)update.version, merged.size(), update.items.size(),
+                      (unsigned)update.removed.size(), (unsigned long)(micros() - start));
+        update.items = std::move(merged);
+        return true;
     }
     
-    // Fetch items from API
-    bool fetchItems(std::vector<Item>& items) {
-        if (!isWiFiConnected()) {
-            Serial.println("WiFi not connected, using cached data");
-            return loadCachedItems(items);
+    // Alleen de items die in deze bak mogen (netwerk taak, na mergeDelta)
+    void filterItems(CatalogUpdate& update, const std::vector<int32_t>& allowedIds) {
+        if (update.kind == CatalogUpdate::UNCHANGED || allowedIds.empty()) return;
+        Catalog filtered;
+        filtered.filterFrom(update.items, allowedIds);
+        Serial.printf("Bin filter: %d of %d items\n", filtered.size(), update.items.size());
+        // Geen enkel id gevonden (filter hoort bij andere data): alles tonen
+        if (!filtered.empty()) update.items = std::move(filtered);
+    }
+    
+    // DEVICE_LOCATION -> trashbin id (/trashBins) -> toegestane item ids
+    // (/trashBinItems/{id}). false bij een netwerk/API fout; een onbekende
+    // locatie geeft true met een leeg filter (alles tonen).
+    bool fetchBinFilter(BinFilter& filter) {
+        if (!isWiFiConnected()) return false;
+        filter = BinFilter();
+        
+        if (api.request("GET", "/trashBins").send(5000) != HTTP_CODE_OK) {
+            api.end();
+            return false;
         }
         
-        HTTPClient http;
-        String url = String("http://") + API_HOST + ":" + API_PORT + "/items";
-        
-        Serial.printf("Fetching items from: %s\n", url.c_str());
-        
-        http.begin(url);
-        http.setTimeout(5000);  // 5 second timeout
-        
-        int httpCode = http.GET();
-        
-        if (httpCode == HTTP_CODE_OK) {
-            String payload = http.getString();
-            http.end();
-            
-            // Parse JSON response
-            DynamicJsonDocument doc(32768);
-            DeserializationError error = deserializeJson(doc, payload);
-            
-            if (error) {
-                Serial.printf("JSON parse error: %s\n", error.c_str());
-                return loadCachedItems(items);
-            }
-            
-            // Check source (database or cache from server)
-            dataSource = doc["source"] | "unknown";
-            lastUpdateTime = doc["last_updated"] | "now";
-            usingCachedData = (dataSource == "cache");
-            
-            Serial.printf("Data source: %s\n", dataSource.c_str());
-            if (usingCachedData) {
-                Serial.printf("Server using cached data from: %s\n", lastUpdateTime.c_str());
+        // Rijen zijn tuples (id eerst) of objecten; de locatie is één van
+        // de string kolommen
+        StaticJsonDocument<512> element;
+        JsonStream json(api.body());
+        char key[24];
+        bool done = false;
+        while (json.nextKey(key, sizeof(key))) {
+            if (strcmp(key, "items") != 0) {
+                json.skipValue();
+                continue;
             }
-            
-            // Parse items array
-            items.clear();
-            JsonArray itemsArray = doc["items"];
-            
-            for (JsonVariant v : itemsArray) {
-                Item item;
-                
-                // API returns tuple: [id, name, category, dirty]
-                if (v.is<JsonArray>()) {
-                    JsonArray arr = v.as<JsonArray>();
-                    item.id = arr[0] | 0;
-                    item.name = String(arr[1] | "Unknown");
-                    
-                    // Parse category from string
-                    const char* cat = arr[2] | "waste";
-                    item.category = Item::stringToCategory(cat);
-                    
-                    item.isDirty = arr[3] | false;
-                    item.canBeDirty = true;
-                    item.color = getCategoryColor(item.category);
-                    item.description = "";
-                    item.ledIndex = items.size();
-                }
-                // Or API returns object
-                else if (v.is<JsonObject>()) {
-                    JsonObject obj = v.as<JsonObject>();
-                    item.id = obj["id"] | 0;
-                    item.name = String(obj["name"] | "Unknown");
-                    
-                    const char* cat = obj["category"] | "waste";
-                    item.category = Item::stringToCategory(cat);
-                    
-                    item.isDirty = obj["dirty"] | false;
-                    item.canBeDirty = obj["canBeDirty"] | true;
-                    item.color = getCategoryColor(item.category);
-                    item.description = String(obj["description"] | "");
-                    item.ledIndex = items.size();
+            done = json.forEachElement(element, [&](JsonDocument& doc) {
+                if (doc.is<JsonArray>()) {
+                    for (JsonVariant column : doc.as<JsonArray>()) {
+                        const char* text = column.as<const char*>();
+                        if (text && strcasecmp(text, DEVICE_LOCATION) == 0) {
+                            filter.trashbinId = doc[0] | 0;
+                        }
+                    }
+                } else {
+                    const char* name = doc["name"] | (doc["location"] | "");
+                    if (strcasecmp(name, DEVICE_LOCATION) == 0) filter.trashbinId = doc["id"] | 0;
                 }
-                
-                items.push_back(item);
-            }
-            
-            Serial.printf("Fetched %d items from API\n", items.size());
-            
-            // Cache the data locally
-            saveCachedItems(items);
-            
+                return filter.trashbinId == 0;
+            });
+        }
+        api.end();
+        if (!done) return false;
+        if (filter.trashbinId == 0) {
+            Serial.printf("Location %s is not a known trash bin, showing all items\n", DEVICE_LOCATION);
             return true;
         }
         
-        Serial.printf("HTTP error: %d\n", httpCode);
-        http.end();
-        
-        // Fallback to cached data
-        return loadCachedItems(items);
+        if (api.request("GET", "/trashBinItems").segment((long)filter.trashbinId).send(5000) != HTTP_CODE_OK) {
+            api.end();
+            return false;
+        }
+        // Klein antwoord; alleen "ids" bewaren (namen overslaan)
+        StaticJsonDocument<32> wanted;
+        wanted["ids"] = true;
+        size_t bodyBytes = api.bodyLength() > 0 ? api.bodyLength() : 1024;
+        DynamicJsonDocument doc(JSON_ARRAY_SIZE(bodyBytes / 2 + 1) + 64);
+        DeserializationError error = deserializeJson(doc, api.body(), DeserializationOption::Filter(wanted));
+        api.end();
+        if (error) {
+            Serial.printf("Bin items JSON error: %s\n", error.c_str());
+            return false;
+        }
+        for (JsonVariant id : doc["ids"].as<JsonArray>()) {
+            filter.itemIds.push_back(id | 0);
+        }
+        std::sort(filter.itemIds.begin(), filter.itemIds.end());
+        Serial.printf("Trash bin %d at %s: %u allowed items\n", (int)filter.trashbinId,
+                      DEVICE_LOCATION, (unsigned)filter.itemIds.size());
+        return true;
     }
     
     // Post item selection to API
     bool postItemSelection(const String& location, const String& itemName, bool dirty) {
+        TRACE_SCOPE(TraceName::DB_POST_SELECTION);
         if (!isWiFiConnected()) {
             Serial.println("WiFi not connected, queueing post for later");
             return queuePostForLater(location, itemName, dirty);
         }
         
-        HTTPClient http;
-        String url = String("http://") + API_HOST + ":" + API_PORT + 
-                     "/sentData/" + location + "/" + itemName + "/" + (dirty ? "true" : "false");
-        
-        Serial.printf("Posting to: %s\n", url.c_str());
+        api.request("POST", "/sentData").segment(location.c_str()).segment(itemName.c_str())
+           .segment(dirty ? "true" : "false");
         
-        http.begin(url);
-        http.setTimeout(5000);
+        Serial.printf("Posting: %s\n", api.target());
         
-        int httpCode = http.POST("");
+        int httpCode = api.send(5000);
         
         if (httpCode == HTTP_CODE_OK) {
-            String response = http.getString();
-            http.end();
-            
             // Parse response to check source
             DynamicJsonDocument doc(1024);
-            deserializeJson(doc, response);
+            deserializeJson(doc, api.body());
+            api.end();
             
             const char* source = doc["source"] | "unknown";
             Serial.printf("Post result - source: %s\n", source);
@@ -194,7 +360,7 @@ public:
         }
         
         Serial.printf("POST failed: %d\n", httpCode);
-        http.end();
+        api.end();
         
         // Queue for later
         return queuePostForLater(location, itemName, dirty);
@@ -202,24 +368,17 @@ public:
     
     // Check API/DB status
     bool checkApiStatus(bool& dbOnline, int& pendingPosts) {
+        TRACE_SCOPE(TraceName::DB_CHECK_STATUS);
         if (!isWiFiConnected()) {
             return false;
         }
         
-        HTTPClient http;
-        String url = String("http://") + API_HOST + ":" + API_PORT + "/status";
-        
-        http.begin(url);
-        http.setTimeout(3000);
-        
-        int httpCode = http.GET();
+        int httpCode = api.request("GET", "/status").send(3000);
         
         if (httpCode == HTTP_CODE_OK) {
-            String payload = http.getString();
-            http.end();
-            
             DynamicJsonDocument doc(1024);
-            deserializeJson(doc, payload);
+            deserializeJson(doc, api.body());
+            api.end();
             
             dbOnline = doc["database_online"] | false;
             pendingPosts = doc["pending_posts_count"] | 0;
@@ -230,10 +389,16 @@ public:
             return true;
         }
         
-        http.end();
+        api.end();
         return false;
     }
     
+    // Connection reuse en latency van de API verbinding
+    void printApiStats(Print& out) const { api.printStats(out); }
+
+    // WiFi weg: keep-alive verbinding sluiten (alleen vanaf de netwerk taak)
+    void closeApiConnection() { api.close(); }
+    
     // Getters for status
     bool isUsingCachedData() const { return usingCachedData; }
     String getDataSource() const { return dataSource; }
@@ -250,50 +415,45 @@ private:
         }
     }
     
-    // Save items to local cache
-    bool saveCachedItems(const std::vector<Item>& items) {
-        if (!LittleFS.begin(true)) {
-            Serial.println("LittleFS mount failed for cache save");
-            return false;
-        }
-        
-        DynamicJsonDocument doc(32768);
-        JsonArray arr = doc.createNestedArray("items");
-        
-        for (const auto& item : items) {
-            JsonObject obj = arr.createNestedObject();
-            obj["id"] = item.id;
-            obj["name"] = item.name;
-            obj["category"] = Item::categoryToString(item.category);
-            obj["color"] = String("0x") + String(item.color, HEX);
-            obj["description"] = item.description;
-            obj["canBeDirty"] = item.canBeDirty;
-            obj["isDirty"] = item.isDirty;
-        }
-        
-        File file = LittleFS.open("/db_cache.json", "w");
-        if (!file) {
-            Serial.println("Failed to open cache file for writing");
-            return false;
-        }
-        
-        serializeJson(doc, file);
-        file.close();
-        
-        Serial.printf("Cached %d items to LittleFS\n", items.size());
+    // Korte string waarde uit de stream (null laat target ongewijzigd)
+    static bool readText(JsonStream& json, String& target) {
+        StaticJsonDocument<96> value;
+        if (!json.readValue(value)) return false;
+        const char* text = value.as<const char*>();
+        if (text) target = text;
         return true;
     }
     
-    // Load items from local cache
-    bool loadCachedItems(std::vector<Item>& items) {
-        Serial.println("Loading from local cache...");
-        
-        if (!LittleFS.begin(true)) {
-            Serial.println("LittleFS mount failed");
-            return false;
+    // Eén element uit de /items array
+    void addFetchedItem(Catalog& items, JsonDocument& doc) {
+        // API returns tuple: [id, name, category, dirty]
+        if (doc.is<JsonArray>()) {
+            JsonArray arr = doc.as<JsonArray>();
+            
+            // Parse category from string
+            const char* cat = arr[2] | "waste";
+            ItemCategory category = Item::stringToCategory(cat);
+            
+            items.add(arr[0] | 0, arr[1] | "Unknown", "",
+                      category, getCategoryColor(category), true);
         }
-        
-        File file = LittleFS.open("/db_cache.json", "r");
+        // Or API returns object
+        else if (doc.is<JsonObject>()) {
+            JsonObject obj = doc.as<JsonObject>();
+            
+            const char* cat = obj["category"] | "waste";
+            ItemCategory category = Item::stringToCategory(cat);
+            
+            items.add(obj["id"] | 0, obj["name"] | "Unknown",
+                      obj["description"] | "",
+                      category, getCategoryColor(category),
+                      obj["canBeDirty"] | true);
+        }
+    }
+    
+    // Oude JSON cache (van voor het binaire formaat)
+    bool loadJsonCache(Catalog& items) {
+        File file = LittleFS.open(CATALOG_JSON_CACHE_FILE, "r");
         if (!file) {
             Serial.println("No cache file found");
             return false;
@@ -310,124 +470,224 @@ private:
         
         items.clear();
         JsonArray itemsArray = doc["items"];
+        items.reserve(itemsArray.size());
         
         for (JsonObject obj : itemsArray) {
-            Item item;
-            item.id = obj["id"] | 0;
-            item.name = String(obj["name"] | "Unknown");
-            item.description = String(obj["description"] | "");
-            
             const char* cat = obj["category"] | "waste";
-            item.category = Item::stringToCategory(cat);
-            
             const char* colorStr = obj["color"] | "0x6B4D";
-            item.color = (uint16_t)strtol(colorStr, NULL, 16);
-            
-            item.isDirty = obj["isDirty"] | false;
-            item.canBeDirty = obj["canBeDirty"] | false;
-            item.ledIndex = items.size();
             
-            items.push_back(item);
+            items.add(obj["id"] | 0,
+                      obj["name"] | "Unknown",
+                      obj["description"] | "",
+                      Item::stringToCategory(cat),
+                      (uint16_t)strtol(colorStr, NULL, 16),
+                      obj["canBeDirty"] | false);
         }
-        
-        usingCachedData = true;
-        dataSource = "local_cache";
-        Serial.printf("Loaded %d items from local cache\n", items.size());
-        
-        return items.size() > 0;
+        items.finalize();
+        return true;
     }
     
-    // Queue failed POST for later
-    bool queuePostForLater(const String& location, const String& itemName, bool dirty) {
+public:
+    // Save items to local cache (binair snapshot, zie CatalogFormat)
+    bool saveCachedItems(const Catalog& items) {
+        TRACE_SCOPE(TraceName::DB_SAVE_CACHE);
         if (!LittleFS.begin(true)) {
+            Serial.println("LittleFS mount failed for cache save");
             return false;
         }
         
-        // Load existing queue
-        DynamicJsonDocument doc(8192);
-        File file = LittleFS.open("/pending_posts.json", "r");
-        if (file) {
-            deserializeJson(doc, file);
-            file.close();
+        std::vector<uint8_t> snapshot;
+        items.serialize(snapshot);
+        
+        File file = LittleFS.open(CATALOG_CACHE_FILE, "w");
+        if (!file) {
+            Serial.println("Failed to open cache file for writing");
+            return false;
         }
         
-        if (!doc.containsKey("posts")) {
-            doc.createNestedArray("posts");
+        size_t written = file.write(snapshot.data(), snapshot.size());
+        file.close();
+        if (written != snapshot.size()) {
+            Serial.printf("Cache write incomplete (%u/%u bytes)\n",
+                          (unsigned)written, (unsigned)snapshot.size());
+            LittleFS.remove(CATALOG_CACHE_FILE);
+            return false;
         }
+        LittleFS.remove(CATALOG_JSON_CACHE_FILE);  // Oude cache is nu verouderd
         
-        JsonArray posts = doc["posts"];
-        JsonObject newPost = posts.createNestedObject();
-        newPost["location"] = location;
-        newPost["item"] = itemName;
-        newPost["dirty"] = dirty;
-        newPost["timestamp"] = millis();
+        Serial.printf("Cached %d items to LittleFS (%u bytes)\n", items.size(), (unsigned)snapshot.size());
+        return true;
+    }
+    
+    // Bak filter lokaal bewaren (de gecachte catalogus is al gefilterd;
+    // het filter is nodig voor de partitie/JSON fallback)
+    bool saveBinFilter(const BinFilter& filter) {
+        if (!LittleFS.begin(true)) return false;
+        if (!filter.active()) return LittleFS.remove(BIN_FILTER_FILE);
+        
+        DynamicJsonDocument doc(JSON_OBJECT_SIZE(3) + JSON_ARRAY_SIZE(filter.itemIds.size()) + 64);
+        doc["trashbin_id"] = filter.trashbinId;
+        doc["location"] = DEVICE_LOCATION;
+        JsonArray ids = doc.createNestedArray("ids");
+        for (int32_t id : filter.itemIds) ids.add(id);
+        
+        File file = LittleFS.open(BIN_FILTER_FILE, "w");
+        if (!file) return false;
+        serializeJson(doc, file);
+        file.close();
+        return true;
+    }
+    
+    bool loadBinFilter(BinFilter& filter) {
+        File file = LittleFS.open(BIN_FILTER_FILE, "r");
+        if (!file) return false;
         
-        // Save queue
-        file = LittleFS.open("/pending_posts.json", "w");
-        if (file) {
-            serializeJson(doc, file);
+        DynamicJsonDocument doc(JSON_ARRAY_SIZE(file.size() / 2 + 1) + 128);
+        DeserializationError error = deserializeJson(doc, file);
+        file.close();
+        // Andere locatie ingesteld sinds het opslaan: filter hoort niet bij dit apparaat
+        if (error || strcmp(doc["location"] | "", DEVICE_LOCATION) != 0) return false;
+        
+        filter.trashbinId = doc["trashbin_id"] | 0;
+        filter.itemIds.clear();
+        for (JsonVariant id : doc["ids"].as<JsonArray>()) {
+            filter.itemIds.push_back(id | 0);
+        }
+        std::sort(filter.itemIds.begin(), filter.itemIds.end());
+        return filter.active();
+    }
+    
+    // Binair snapshot uit LittleFS: één read in één buffer, geen parse.
+    // LittleFS kan niet mmappen, dus de buffer blijft als enige heap blok
+    // in gebruik (zie Catalog::loadSnapshot).
+    bool loadSnapshotFile(Catalog& items, const char* path = CATALOG_CACHE_FILE) {
+        File file = LittleFS.open(path, "r");
+        if (!file) return false;
+        if (!HeapWatermark::fits(file.size(), CATALOG_MIN_FREE_HEAP)) {
+            Serial.printf("Snapshot %s too large for RAM (%u bytes)\n", path, (unsigned)file.size());
             file.close();
-            Serial.println("Post queued for later");
-            return true;
+            return false;
         }
         
+        std::vector<uint8_t> buffer(file.size());
+        size_t got = file.read(buffer.data(), buffer.size());
+        file.close();
+        
+        const char* error = "short read";
+        if (got == buffer.size() && items.loadSnapshot(std::move(buffer), &error)) {
+            return true;
+        }
+        Serial.printf("Snapshot %s rejected: %s\n", path, error);
         return false;
     }
     
-public:
-    // Process queued posts when connection is restored
-    int processPendingPosts() {
-        if (!isWiFiConnected()) {
-            return 0;
-        }
+    // Load items from local cache (binair, anders de oude JSON cache)
+    bool loadCachedItems(Catalog& items) {
+        TRACE_SCOPE(TraceName::DB_LOAD_CACHE);
+        Serial.println("Loading from local cache...");
         
         if (!LittleFS.begin(true)) {
-            return 0;
+            Serial.println("LittleFS mount failed");
+            return false;
         }
         
-        File file = LittleFS.open("/pending_posts.json", "r");
-        if (!file) {
-            return 0;
+        uint32_t start = micros();
+        const char* format = "binary";
+        if (!loadSnapshotFile(items)) {
+            format = "json";
+            if (!loadJsonCache(items)) return false;
         }
         
-        DynamicJsonDocument doc(8192);
-        deserializeJson(doc, file);
-        file.close();
+        usingCachedData = true;
+        dataSource = "local_cache";
+        Serial.printf("Loaded %d items from local cache (%s, %lu us)\n",
+                      items.size(), format, (unsigned long)(micros() - start));
         
-        if (!doc.containsKey("posts")) {
+        return items.size() > 0;
+    }
+    
+    // Queue failed POST for later (append-only log op flash, zie OutboxLog)
+    bool queuePostForLater(const String& location, const String& itemName, bool dirty) {
+        TRACE_SCOPE(TraceName::DB_QUEUE_POST);
+        if (!OutboxLog::getInstance().append(location.c_str(), itemName.c_str(), dirty)) {
+            return false;
+        }
+        Serial.println("Post queued for later");
+        return true;
+    }
+    
+    // Process queued posts when connection is restored. Opeenvolgende posts
+    // voor dezelfde locatie gaan in batches van PENDING_BATCH_SIZE naar
+    // /sentBatch: één request en één DB transactie per batch. Pas na een
+    // geslaagde batch gaat de outbox cursor vooruit; bij een tijdelijke
+    // fout (geen antwoord, 5xx) stoppen (ok = false), de rest blijft staan.
+    // Alleen 400/413/422 (de batch zelf is fout) komt bij opnieuw proberen
+    // ook terug: die batch gaat naar de dead file en de cursor voorbij. Al
+    // het andere (404 van een oude API, 408, 429, ...) blijft staan.
+    // maxBatches 0 = alles.
+    int processPendingPosts(size_t maxBatches, bool& ok) {
+        TRACE_SCOPE(TraceName::DB_PROCESS_PENDING);
+        ok = false;
+        if (!isWiFiConnected()) {
             return 0;
         }
         
-        JsonArray posts = doc["posts"];
-        int processed = 0;
-        
-        for (JsonObject post : posts) {
-            String location = post["location"] | "";
-            String item = post["item"] | "";
-            bool dirty = post["dirty"] | false;
-            
-            HTTPClient http;
-            String url = String("http://") + API_HOST + ":" + API_PORT + 
-                         "/sentData/" + location + "/" + item + "/" + (dirty ? "true" : "false");
-            
-            http.begin(url);
-            http.setTimeout(5000);
-            
-            if (http.POST("") == HTTP_CODE_OK) {
-                processed++;
+        ok = true;
+        OutboxLog& outbox = OutboxLog::getInstance();
+        uint32_t start = millis();
+        size_t processed = 0;
+        size_t batches = 0;
+        while (maxBatches == 0 || batches < maxBatches) {
+            OutboxPosition next;
+            size_t count = outbox.read(outboxBatch, PENDING_BATCH_SIZE, next);
+            if (count == 0) break;
+            int httpCode = postBatch(outboxBatch, count);
+            if ((httpCode == 400 || httpCode == 413 || httpCode == 422) &&
+                outbox.deadLetter(outboxBatch, count, next)) {
+                Serial.printf("Batch of %u posts rejected (%d), moved to dead file\n",
+                              (unsigned)count, httpCode);
+                batches++;
+                continue;
             }
-            
-            http.end();
+            if (httpCode != HTTP_CODE_OK) {
+                Serial.printf("Batch of %u posts failed: %d\n", (unsigned)count, httpCode);
+                ok = false;
+                break;
+            }
+            outbox.commit(next, count);
+            processed += count;
+            batches++;
         }
         
-        // Clear the queue
         if (processed > 0) {
-            LittleFS.remove("/pending_posts.json");
-            Serial.printf("Processed %d pending posts\n", processed);
+            Serial.printf("Processed %u pending posts in %u batches (%lu ms), %u left\n",
+                          (unsigned)processed, (unsigned)batches,
+                          (unsigned long)(millis() - start), (unsigned)outbox.pending());
         }
-        
         return processed;
     }
+    
+private:
+    // Eén batch als [[item, dirty], ...] naar /sentBatch/{location}; geeft
+    // de HTTP status (negatief zonder antwoord)
+    int postBatch(const OutboxRecord* records, size_t count) {
+        DynamicJsonDocument batch(JSON_ARRAY_SIZE(PENDING_BATCH_SIZE) +
+                                  PENDING_BATCH_SIZE * JSON_ARRAY_SIZE(2));
+        JsonArray selections = batch.to<JsonArray>();
+        for (size_t i = 0; i < count; i++) {
+            JsonArray selection = selections.createNestedArray();
+            selection.add((const char*)records[i].item);  // Geen kopie
+            selection.add(records[i].dirty ? 1 : 0);
+        }
+        size_t length = measureJson(selections);
+        std::vector<char> body(length + 1);
+        serializeJson(selections, body.data(), body.size());
+        
+        api.request("POST", "/sentBatch").segment(records[0].location);
+        int httpCode = api.send(10000, body.data(), length);
+        api.end();
+        return httpCode;
+    }
 };
 
 #endif
@@ -0,0 +1,169 @@
+#ifndef JSON_STREAM_H
+#define JSON_STREAM_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// Loopt een JSON object op een Stream (bijv. de WiFiClient van een HTTP
+// response) sleutel voor sleutel af, zonder het antwoord te bufferen. Een
+// array wordt element voor element gedeserialiseerd in een klein document
+// dat steeds opnieuw gebruikt wordt: geheugen blijft gelijk, hoe groot de
+// array ook is. De haakjes en komma's lezen we zelf; ArduinoJson leest
+// alleen de waarden en stopt direct na elke waarde.
+//
+//   JsonStream json(http.getStream());
+//   char key[24];
+//   while (json.nextKey(key, sizeof(key))) {
+//     if (strcmp(key, "items") == 0) json.forEachElement(doc, onItem);
+//     else json.skipValue();
+//   }
+//   if (!json.ok()) ...
+class JsonStream {
+private:
+  Stream& stream;
+  bool started = false;
+  bool failed = false;
+
+  // Volgende teken dat geen witruimte is, zonder het te lezen; wacht
+  // maximaal de stream timeout op data. -1 bij timeout/einde.
+  int peekToken() {
+    unsigned long start = millis();
+    while (true) {
+      int c = stream.peek();
+      if (c < 0) {
+        if (millis() - start > stream.getTimeout()) return -1;
+        delay(1);
+        continue;
+      }
+      if (c != ' ' && c != '\n' && c != '\r' && c != '\t') return c;
+      stream.read();
+      start = millis();
+    }
+  }
+
+  bool expect(char c) {
+    if (peekToken() != c) return fail();
+    stream.read();
+    return true;
+  }
+
+  bool fail() {
+    failed = true;
+    return false;
+  }
+
+  bool check(DeserializationError error) {
+    if (!error) return true;
+    Serial.printf("JSON stream error: %s\n", error.c_str());
+    return fail();
+  }
+
+public:
+  explicit JsonStream(Stream& source) : stream(source) {}
+
+  // Volgende sleutel van het top-level object; false aan het eind of bij
+  // een fout (zie ok()). Te lange sleutels worden afgekapt.
+  bool nextKey(char* key, size_t keySize) {
+    if (failed) return false;
+    if (!started) {
+      started = true;
+      if (!expect('{')) return false;
+    } else {
+      int c = peekToken();
+      if (c == '}') {
+        stream.read();
+        return false;
+      }
+      // Na een getal heeft ArduinoJson de komma al gelezen (één teken
+      // vooruit); dan staat hier meteen de volgende sleutel
+      if (c == ',') stream.read();
+      else if (c != '"') return fail();
+    }
+    if (peekToken() == '}') {  // Leeg object
+      stream.read();
+      return false;
+    }
+
+    // Sleutel is een gewone JSON string; ArduinoJson lost escapes op
+    StaticJsonDocument<64> name;
+    if (!check(deserializeJson(name, stream))) return false;
+    const char* text = name.as<const char*>();
+    if (!text) return fail();
+    strlcpy(key, text, keySize);
+    return expect(':');
+  }
+
+  // Waarde van de huidige sleutel in doc (alleen voor kleine waarden)
+  bool readValue(JsonDocument& doc) {
+    if (failed) return false;
+    return check(deserializeJson(doc, stream));
+  }
+
+  // Waarde van de huidige sleutel overslaan (leeg filter: niets bewaard)
+  bool skipValue() {
+    if (failed) return false;
+    StaticJsonDocument<16> filter;
+    StaticJsonDocument<16> ignored;
+    return check(deserializeJson(ignored, stream, DeserializationOption::Filter(filter)));
+  }
+
+  // Stoppen zonder de rest te lezen (bijv. het antwoord past niet); de
+  // stream staat daarna midden in een waarde, dus de verbinding sluiten
+  void abort() { failed = true; }
+
+  // Huidige waarde is een array van objecten of arrays: onElement(doc) per
+  // element. onElement geeft false om te stoppen (de rest van de array
+  // wordt overgeslagen), of roept abort() aan om direct op te houden.
+  template <typename F>
+  bool forEachElement(JsonDocument& doc, F onElement) {
+    if (failed || !expect('[')) return false;
+    if (peekToken() == ']') {
+      stream.read();
+      return true;
+    }
+    bool wanted = true;
+    while (true) {
+      if (wanted) {
+        if (!check(deserializeJson(doc, stream))) return false;
+        wanted = onElement(doc);
+        if (failed) return false;
+      } else if (!skipValue()) {
+        return false;
+      }
+      int c = peekToken();
+      if (c == ']') {
+        stream.read();
+        return true;
+      }
+      if (!expect(',')) return false;
+    }
+  }
+
+  bool ok() const { return !failed; }
+};
+
+// Doorgeefluik dat de gelezen bytes telt (bijv. bytes per sync)
+class CountingStream : public Stream {
+private:
+  Stream& source;
+  size_t count = 0;
+
+public:
+  explicit CountingStream(Stream& wrapped) : source(wrapped) {
+    setTimeout(wrapped.getTimeout());
+  }
+
+  int available() override { return source.available(); }
+  int read() override {
+    int c = source.read();
+    if (c >= 0) count++;
+    return c;
+  }
+  int peek() override { return source.peek(); }
+  size_t write(uint8_t b) override { return source.write(b); }
+  using Print::write;
+
+  size_t bytesRead() const { return count; }
+};
+
+#endif
@@ -4,6 +4,7 @@
 #include <FastLED.h>
 #include "../config.h"
 #include "../models/Item.h"
+#include "../diagnostics/Tracer.h"
 
 enum class LEDAnimationType {
   PULSE,
@@ -144,6 +145,7 @@ public:
 
   void update() {
     if (!isAnimating) return;
+    TRACE_SCOPE(TraceName::LED_UPDATE);
 
     unsigned long elapsed = millis() - currentAnimation.startTime;
     float progress = fmod((float)elapsed / currentAnimation.duration, 1.0);
@@ -0,0 +1,312 @@
+#ifndef NETWORK_SERVICE_H
+#define NETWORK_SERVICE_H
+
+#include <Arduino.h>
+#include "DatabaseService.h"
+#include "../config.h"
+#include "../events/Event.h"
+
+// Alle DatabaseService netwerk I/O draait in een eigen FreeRTOS taak op
+// core 0. De UI (core 1) zet jobs in een begrensde outbox queue en krijgt
+// resultaten terug via poll() -> NETWORK_RESULT events op de UI thread.
+
+enum class NetworkJobType : uint8_t {
+  POST_SELECTION,
+  PROCESS_PENDING,
+  CHECK_STATUS,
+  FETCH_CATALOG,
+  FETCH_BIN_FILTER,
+  CLOSE_CONNECTION          // WiFi weg: keep-alive socket sluiten, geen resultaat
+};
+
+struct NetworkJob {
+  NetworkJobType type;
+  bool dirty;
+  uint32_t enqueuedAt;      // millis() bij enqueue
+  uint32_t sinceVersion;    // FETCH_CATALOG: versie van de lokale catalogus
+  uint16_t maxBatches;      // PROCESS_PENDING: max batches per job (0 = alles)
+  uint32_t generation;      // PROCESS_PENDING: flusher generatie, komt terug in het resultaat
+  const Catalog* base;      // FETCH_CATALOG: alleen lezen, blijft staan tot het resultaat
+  std::vector<int32_t>* allowedIds;  // FETCH_CATALOG: kopie van het bak filter (eigendom van de job)
+  char location[32];
+  char itemName[48];
+};
+
+struct NetworkResult {
+  NetworkJobType type;
+  bool success;
+  int value;                // Job-specifiek (bijv. aantal verwerkte posts; -1 = catalogus past niet)
+  uint32_t latencyMs;       // Enqueue -> klaar
+  CatalogUpdate* update;    // FETCH_CATALOG: eigendom gaat naar de UI thread
+  BinFilter* binFilter;     // FETCH_BIN_FILTER: idem
+  uint32_t generation;      // Kopie van NetworkJob::generation
+};
+
+struct LatencyStats {
+  uint32_t count = 0;
+  uint32_t lastMs = 0;
+  uint32_t maxMs = 0;
+  uint64_t totalMs = 0;
+
+  void add(uint32_t ms) {
+    count++;
+    lastMs = ms;
+    totalMs += ms;
+    if (ms > maxMs) maxMs = ms;
+  }
+
+  uint32_t avgMs() const { return count ? (uint32_t)(totalMs / count) : 0; }
+};
+
+class NetworkService {
+private:
+  QueueHandle_t outbox = nullptr;
+  QueueHandle_t results = nullptr;
+  TaskHandle_t taskHandle = nullptr;
+  portMUX_TYPE statsLock = portMUX_INITIALIZER_UNLOCKED;
+
+  // Statistieken (geschreven op core 0, gelezen op core 1)
+  LatencyStats postLatency;     // Enqueue -> POST afgerond
+  LatencyStats httpLatency;     // Alleen de HTTP call
+  uint32_t maxDepth = 0;
+  uint32_t overflowed = 0;      // Outbox vol -> direct naar LittleFS queue
+
+  NetworkService() {}
+
+  static void taskEntry(void* arg) {
+    static_cast<NetworkService*>(arg)->taskLoop();
+  }
+
+  void taskLoop() {
+    // Offline outbox van vorige keer inlezen (segmenten scannen) hier, niet
+    // op de UI thread tijdens het opstarten
+    OutboxLog::getInstance().begin();
+    NetworkJob job;
+    for (;;) {
+      if (xQueueReceive(outbox, &job, portMAX_DELAY) != pdTRUE) continue;
+      processJob(job);
+    }
+  }
+
+  void processJob(const NetworkJob& job) {
+    DatabaseService& db = DatabaseService::getInstance();
+    if (job.type == NetworkJobType::CLOSE_CONNECTION) {
+      db.closeApiConnection();
+      return;
+    }
+
+    NetworkResult result = {job.type, false, 0, 0, nullptr, nullptr, job.generation};
+    uint32_t start = millis();
+
+    switch (job.type) {
+      case NetworkJobType::POST_SELECTION:
+        result.success = db.postItemSelection(job.location, job.itemName, job.dirty);
+        break;
+      case NetworkJobType::PROCESS_PENDING:
+      {
+        // Batch voor batch: staat er intussen een andere job klaar (een
+        // selectie van de gebruiker), dan stopt de flush na de lopende
+        // batch en gaat de flusher bij een volgende tick verder
+        bool ok = true;
+        int sent = 0;
+        for (uint16_t batch = 0; ok && (job.maxBatches == 0 || batch < job.maxBatches); batch++) {
+          int count = db.processPendingPosts(1, ok);
+          sent += count;
+          if (count == 0 || uxQueueMessagesWaiting(outbox) > 0) break;
+        }
+        result.value = sent;
+        result.success = ok;
+        break;
+      }
+      case NetworkJobType::CHECK_STATUS: {
+        bool dbOnline = false;
+        int pending = 0;
+        result.success = db.checkApiStatus(dbOnline, pending) && dbOnline;
+        result.value = pending;
+        break;
+      }
+      case NetworkJobType::FETCH_CATALOG: {
+        CatalogUpdate* fetched = new CatalogUpdate();
+        result.success = db.fetchItems(*fetched, job.sinceVersion) &&
+                         (!job.base || db.mergeDelta(*fetched, *job.base));
+        if (result.success && fetched->kind != CatalogUpdate::UNCHANGED) {
+          if (job.allowedIds) db.filterItems(*fetched, *job.allowedIds);
+          db.saveCachedItems(fetched->items);
+        }
+        delete job.allowedIds;
+        result.value = fetched->tooLarge ? -1 : (int)fetched->items.size();
+        if (result.success) {
+          result.update = fetched;
+        } else {
+          delete fetched;
+        }
+        break;
+      }
+      case NetworkJobType::FETCH_BIN_FILTER: {
+        BinFilter* filter = new BinFilter();
+        result.success = db.fetchBinFilter(*filter);
+        result.value = filter->itemIds.size();
+        if (result.success) {
+          result.binFilter = filter;
+        } else {
+          delete filter;
+        }
+        break;
+      }
+      case NetworkJobType::CLOSE_CONNECTION:
+        break;
+    }
+
+    uint32_t end = millis();
+    result.latencyMs = end - job.enqueuedAt;
+
+    if (job.type == NetworkJobType::POST_SELECTION) {
+      portENTER_CRITICAL(&statsLock);
+      httpLatency.add(end - start);
+      postLatency.add(result.latencyMs);
+      portEXIT_CRITICAL(&statsLock);
+    }
+
+    // Niet blokkeren als de UI achterloopt; een catalogus gaat niet verloren
+    // omdat FETCH_CATALOG wacht tot er plek is. Een flush resultaat ook
+    // niet: de OutboxFlusher telt zijn job pas af bij dat resultaat.
+    TickType_t wait = (result.update || result.binFilter ||
+                       job.type == NetworkJobType::PROCESS_PENDING) ? portMAX_DELAY : 0;
+    xQueueSend(results, &result, wait);
+  }
+
+  bool enqueue(NetworkJob& job) {
+    if (!outbox) return false;
+    job.enqueuedAt = millis();
+    if (xQueueSend(outbox, &job, 0) != pdTRUE) {
+      return false;
+    }
+    uint32_t depth = uxQueueMessagesWaiting(outbox);
+    if (depth > maxDepth) maxDepth = depth;
+    return true;
+  }
+
+public:
+  static NetworkService& getInstance() {
+    static NetworkService instance;
+    return instance;
+  }
+
+  NetworkService(const NetworkService&) = delete;
+  void operator=(const NetworkService&) = delete;
+
+  void begin() {
+    if (taskHandle) return;
+
+    outbox = xQueueCreate(NETWORK_OUTBOX_SIZE, sizeof(NetworkJob));
+    results = xQueueCreate(NETWORK_OUTBOX_SIZE, sizeof(NetworkResult));
+
+    xTaskCreatePinnedToCore(taskEntry, "network", NETWORK_TASK_STACK, this,
+                            NETWORK_TASK_PRIORITY, &taskHandle, NETWORK_TASK_CORE);
+    Serial.printf("NetworkService started on core %d (outbox %d)\n",
+                  NETWORK_TASK_CORE, NETWORK_OUTBOX_SIZE);
+  }
+
+  // Non-blocking; bij een volle outbox gaat de selectie naar de LittleFS queue
+  bool enqueueSelection(const char* location, const char* itemName, bool dirty) {
+    NetworkJob job = {};
+    job.type = NetworkJobType::POST_SELECTION;
+    job.dirty = dirty;
+    strlcpy(job.location, location, sizeof(job.location));
+    strlcpy(job.itemName, itemName, sizeof(job.itemName));
+
+    if (enqueue(job)) return true;
+
+    overflowed++;
+    Serial.println("Network outbox full, queueing selection on flash");
+    return DatabaseService::getInstance().queuePostForLater(location, itemName, dirty);
+  }
+
+  bool enqueueProcessPending(uint16_t maxBatches = 0, uint32_t generation = 0) {
+    NetworkJob job = {};
+    job.type = NetworkJobType::PROCESS_PENDING;
+    job.maxBatches = maxBatches;
+    job.generation = generation;
+    return enqueue(job);
+  }
+
+  // Met een base catalogus alleen de wijzigingen sinds zijn versie ophalen;
+  // de delta wordt hier op de netwerk taak samengevoegd. De aanroeper laat
+  // base ongemoeid tot het resultaat binnen is. Met een bak filter blijven
+  // alleen die items over (ook in de LittleFS cache).
+  bool enqueueCatalogFetch(const Catalog* base = nullptr, const BinFilter* filter = nullptr) {
+    NetworkJob job = {};
+    job.type = NetworkJobType::FETCH_CATALOG;
+    job.base = base;
+    job.sinceVersion = base ? base->getDataVersion() : 0;
+    if (filter && filter->active()) job.allowedIds = new std::vector<int32_t>(filter->itemIds);
+    if (enqueue(job)) return true;
+    delete job.allowedIds;
+    return false;
+  }
+
+  bool enqueueBinFilterFetch() {
+    NetworkJob job = {};
+    job.type = NetworkJobType::FETCH_BIN_FILTER;
+    return enqueue(job);
+  }
+
+  // De socket is van de netwerk taak; sluiten gaat daarom ook via de queue
+  bool enqueueConnectionClose() {
+    NetworkJob job = {};
+    job.type = NetworkJobType::CLOSE_CONNECTION;
+    return enqueue(job);
+  }
+
+  bool enqueueStatusCheck() {
+    NetworkJob job = {};
+    job.type = NetworkJobType::CHECK_STATUS;
+    return enqueue(job);
+  }
+
+  // UI thread: resultaten omzetten naar events
+  void poll() {
+    if (!results) return;
+    NetworkResult result;
+    while (xQueueReceive(results, &result, 0) == pdTRUE) {
+      Event event;
+      event.type = EventType::NETWORK_RESULT;
+      event.param1 = (int)result.type;
+      event.param2 = result.success ? result.value : -1;
+      event.data = &result;
+      EventBus::getInstance().dispatch(event);
+      delete result.update;  // Listener heeft de inhoud overgenomen
+      delete result.binFilter;
+    }
+  }
+
+  uint32_t getOutboxDepth() const {
+    return outbox ? uxQueueMessagesWaiting(outbox) : 0;
+  }
+
+  void printStats(Print& out) {
+    portENTER_CRITICAL(&statsLock);
+    LatencyStats post = postLatency;
+    LatencyStats http = httpLatency;
+    portEXIT_CRITICAL(&statsLock);
+
+    out.printf("outbox: depth=%u max=%u cap=%d overflowed=%u\n",
+               getOutboxDepth(), maxDepth, NETWORK_OUTBOX_SIZE, overflowed);
+    out.printf("post latency: n=%u last=%ums avg=%ums max=%ums\n",
+               post.count, post.lastMs, post.avgMs(), post.maxMs);
+    out.printf("http latency: n=%u last=%ums avg=%ums max=%ums\n",
+               http.count, http.lastMs, http.avgMs(), http.maxMs);
+    DatabaseService::getInstance().printApiStats(out);
+    OutboxLog::getInstance().printStats(out);
+    printTaskInfo(out);
+  }
+
+  void printTaskInfo(Print& out) {
+    if (taskHandle) {
+      out.printf("  %-10s stack free %u bytes, core %d\n", "network",
+                 (unsigned)uxTaskGetStackHighWaterMark(taskHandle), NETWORK_TASK_CORE);
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,151 @@
+#ifndef OUTBOX_FLUSHER_H
+#define OUTBOX_FLUSHER_H
+
+#include <Arduino.h>
+#include <esp_system.h>
+#include "../config.h"
+#include "NetworkService.h"
+#include "OutboxLog.h"
+#include "WiFiManager.h"
+
+// Leegt de offline outbox (OutboxLog) op de achtergrond zolang de API
+// bereikbaar is. tick() draait op de UI thread maar beslist alleen: het
+// versturen zelf is een PROCESS_PENDING job op de netwerk taak, van
+// hooguit OUTBOX_FLUSH_BATCHES batches. Komt er een selectie in de
+// netwerk outbox, dan stopt de job na de lopende batch: een selectie
+// wacht hooguit één batch request (timeout 10 s) op de flush.
+//
+//  - Hooguit OUTBOX_MAX_IN_FLIGHT flush jobs tegelijk in de netwerk outbox,
+//    ook als er nog een job van vóór een reconnect in de queue staat
+//  - Mislukt een flush: exponential backoff met jitter (0..50%), net als
+//    WiFiManager; een geslaagde flush of een nieuwe WiFi verbinding zet de
+//    backoff terug
+//  - Gepauzeerd zolang iemand het scherm bedient (OUTBOX_IDLE_MS na de
+//    laatste aanraking)
+class OutboxFlusher {
+public:
+  struct Stats {
+    uint32_t jobs = 0;
+    uint32_t failures = 0;
+    uint32_t paused = 0;          // Ticks overgeslagen voor de gebruiker
+    uint32_t drained = 0;         // Records verstuurd
+    uint32_t drainMs = 0;         // Flush jobs, enqueue tot klaar
+    uint32_t lastRate = 0;        // Records/s van de laatste flush job
+    uint32_t maxAgeMs = 0;        // Langste tijd dat er een achterstand was
+
+    // Records per seconde over alle flush jobs samen
+    float drainRate() const { return drainMs ? 1000.0f * drained / drainMs : 0.0f; }
+  };
+
+private:
+  uint32_t inFlight = 0;
+  uint32_t generation = 0;        // Omhoog bij kick(); oudere resultaten sturen niets meer bij
+  uint32_t backoffMs = OUTBOX_BACKOFF_MIN_MS;
+  uint32_t nextAttempt = 0;
+  uint32_t lastActivity = 0;
+  uint32_t backlogSince = 0;      // 0 = outbox leeg
+  Stats stats;
+
+  OutboxFlusher() {}
+
+  void updateAge(uint32_t now) {
+    if (OutboxLog::getInstance().pending() == 0) {
+      backlogSince = 0;
+      return;
+    }
+    if (backlogSince == 0) backlogSince = now ? now : 1;
+    uint32_t age = backlogAgeMs();
+    if (age > stats.maxAgeMs) stats.maxAgeMs = age;
+  }
+
+public:
+  static OutboxFlusher& getInstance() {
+    static OutboxFlusher instance;
+    return instance;
+  }
+
+  OutboxFlusher(const OutboxFlusher&) = delete;
+  void operator=(const OutboxFlusher&) = delete;
+
+  // Aanraking: even niet flushen
+  void noteActivity() { lastActivity = millis(); }
+
+  // Nieuwe verbinding: direct proberen, backoff opnieuw. Een job van vóór
+  // de onderbreking houdt zijn plek tot zijn resultaat binnen is, maar
+  // dat resultaat zet geen backoff meer (andere generatie).
+  void kick() {
+    generation++;
+    backoffMs = OUTBOX_BACKOFF_MIN_MS;
+    nextAttempt = millis();
+  }
+
+  // Periodiek vanuit de scheduler
+  void tick() {
+    uint32_t now = millis();
+    updateAge(now);
+    if (backlogSince == 0 || !WiFiManager::getInstance().isConnected()) return;
+    if (inFlight >= OUTBOX_MAX_IN_FLIGHT || (int32_t)(now - nextAttempt) < 0) return;
+    if (now - lastActivity < OUTBOX_IDLE_MS) {
+      stats.paused++;
+      return;
+    }
+    if (NetworkService::getInstance().enqueueProcessPending(OUTBOX_FLUSH_BATCHES, generation)) {
+      inFlight++;
+      stats.jobs++;
+    }
+  }
+
+  // Resultaat van een PROCESS_PENDING job (UI thread). Elke job levert
+  // precies één resultaat (NetworkService wacht daarvoor op de queue).
+  void onResult(bool success, int processed, uint32_t jobMs, uint32_t jobGeneration) {
+    if (inFlight > 0) inFlight--;
+    uint32_t now = millis();
+    if (processed > 0) {
+      stats.drained += processed;
+      stats.drainMs += jobMs;
+      stats.lastRate = jobMs ? 1000 * processed / jobMs : processed;
+    }
+    if (jobGeneration != generation) {
+      // Van vóór de laatste kick(): de backoff hoort bij de nieuwe verbinding
+      updateAge(now);
+      return;
+    }
+    if (success) {
+      backoffMs = OUTBOX_BACKOFF_MIN_MS;
+      nextAttempt = now;  // Meer in de outbox: volgende tick verder
+    } else {
+      stats.failures++;
+      uint32_t jitter = esp_random() % (backoffMs / 2 + 1);
+      nextAttempt = now + backoffMs + jitter;
+      Serial.printf("Outbox flush failed, retry in %u ms (%u pending)\n",
+                    (unsigned)(backoffMs + jitter), (unsigned)OutboxLog::getInstance().pending());
+      backoffMs = backoffMs * 2 > OUTBOX_BACKOFF_MAX_MS ? OUTBOX_BACKOFF_MAX_MS : backoffMs * 2;
+    }
+    updateAge(now);
+  }
+
+  // Hoe lang er al een achterstand is (0 = outbox leeg): de leeftijd van
+  // de oudste selectie (ook van voor een reboot, zie OutboxLog), anders
+  // vanaf het moment dat de achterstand in deze boot ontstond
+  uint32_t backlogAgeMs() const {
+    if (!backlogSince) return 0;
+    uint32_t age;
+    return OutboxLog::getInstance().oldestAgeMs(age) ? age : millis() - backlogSince;
+  }
+
+  const Stats& getStats() const { return stats; }
+
+  void printStats(Print& out) {
+    uint32_t now = millis();
+    uint32_t wait = (int32_t)(now - nextAttempt) >= 0 ? 0 : nextAttempt - now;
+    out.printf("outbox flush: %u pending, age %lu ms (max %lu), %u in flight, next try in %lu ms\n",
+               (unsigned)OutboxLog::getInstance().pending(), (unsigned long)backlogAgeMs(),
+               (unsigned long)stats.maxAgeMs, (unsigned)inFlight, (unsigned long)wait);
+    out.printf("  %u jobs, %u failed, %u paused, %u drained at %.1f/s (last %u/s), backoff %u ms\n",
+               (unsigned)stats.jobs, (unsigned)stats.failures, (unsigned)stats.paused,
+               (unsigned)stats.drained, stats.drainRate(), (unsigned)stats.lastRate,
+               (unsigned)backoffMs);
+  }
+};
+
+#endif
@@ -0,0 +1,621 @@
+#ifndef OUTBOX_LOG_H
+#define OUTBOX_LOG_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <LittleFS.h>
+#include <Preferences.h>
+#include <time.h>
+#include <vector>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "../config.h"
+#include "../models/CatalogFormat.h"  // CatalogFormat::crc32()
+
+// Een selectie die (nog) niet bij de API is aangekomen. millis() alleen
+// zegt na een reboot niets meer; epoch (SNTP) en de boot teller wel.
+struct OutboxRecord {
+  uint32_t epoch;          // Unix tijd bij het opslaan (0 = klok nog niet gezet)
+  uint32_t uptimeMs;       // millis() bij het opslaan
+  uint16_t boot;           // Boot teller bij het opslaan
+  bool dirty;
+  char location[32];
+  char item[48];
+};
+
+// Plek in de log: segment nummer + byte offset in dat segment
+struct OutboxPosition {
+  uint32_t segment;
+  uint32_t offset;
+
+  bool operator==(const OutboxPosition& other) const {
+    return segment == other.segment && offset == other.offset;
+  }
+  bool operator!=(const OutboxPosition& other) const { return !(*this == other); }
+};
+
+// Offline selecties als append-only log op LittleFS (OUTBOX_DIR).
+//
+// Elke selectie is één frame [magic, lengte, CRC32, payload] achteraan het
+// laatste segment: een append schrijft alleen dat frame (O(1)), de rest van
+// de queue wordt niet gelezen of herschreven. Segmenten ("00000001.log")
+// worden OUTBOX_SEGMENT_BYTES groot; daarna begint een nieuw segment.
+//
+// De commit cursor (OUTBOX_DIR "/cursor", met eigen CRC) wijst naar het
+// eerste frame dat nog niet bevestigd is. Pas na een geslaagde upload gaat
+// hij vooruit (at-least-once: na een stroomstoring kan een batch dubbel
+// aankomen, maar er gaat niets verloren). Segmenten helemaal vóór de cursor
+// worden verwijderd; is alles verstuurd, dan begint de log opnieuw.
+//
+// Een frame met een verkeerde CRC (bijv. half geschreven bij een
+// stroomstoring) sluit zijn segment af: lezen gaat verder bij het volgende
+// segment, nieuwe appends komen in een vers segment.
+//
+// Batches die de API blijvend weigert gaan als dezelfde frames naar
+// OUTBOX_DIR "/dead" (hooguit OUTBOX_DEAD_MAX_BYTES): te bekijken met
+// 'outbox dead' en terug in de log te zetten met 'outbox replay'.
+//
+// De UI thread (volle netwerk outbox) en de netwerk taak schrijven allebei;
+// alle bestandstoegang loopt via een mutex.
+class OutboxLog {
+public:
+  struct Stats {
+    uint32_t appended = 0;
+    uint32_t committed = 0;
+    uint32_t rejected = 0;     // Flash budget op
+    uint32_t crcErrors = 0;
+    uint32_t rotations = 0;
+    uint32_t segmentsRemoved = 0;
+    uint32_t migrated = 0;     // Uit het oude /pending_posts.json
+    uint32_t deadLettered = 0; // Door de API geweigerd, naar de dead file
+  };
+
+private:
+  static const uint16_t FRAME_MAGIC = 0x4F43;         // Met epoch + boot teller
+  static const uint16_t FRAME_MAGIC_MILLIS = 0x4F42;  // Oud: alleen millis()
+  static const size_t FIELDS = 13;                    // epoch, boot, millis, dirty, 2 lengtes
+  static const size_t MAX_PAYLOAD = FIELDS + sizeof(OutboxRecord::location) + sizeof(OutboxRecord::item);
+
+  struct FrameHeader {
+    uint16_t magic;
+    uint16_t length;
+    uint32_t crc;
+  };
+
+  struct CursorFile {
+    OutboxPosition position;
+    uint32_t crc;
+  };
+
+  SemaphoreHandle_t lock;
+  bool ready = false;
+  OutboxPosition cursor = {1, 0};  // Eerste niet bevestigde frame
+  OutboxPosition tail = {1, 0};    // Hier komt de volgende append
+  uint32_t firstSegment = 1;       // Oudste segment op flash
+  uint32_t depth = 0;              // Frames tussen cursor en tail
+  uint32_t logBytes = 0;           // Alle segmenten samen
+  uint32_t deadBytes = 0;          // OUTBOX_DIR "/dead"
+  uint16_t boot = 0;               // Deze boot (NVS "outbox"/"boot")
+  OutboxRecord head;               // Oudste record, voor de leeftijd
+  bool hasHead = false;
+  Stats stats;
+
+  OutboxLog() : lock(xSemaphoreCreateMutex()) {}
+
+  class Guard {
+    SemaphoreHandle_t handle;
+  public:
+    explicit Guard(SemaphoreHandle_t h) : handle(h) { xSemaphoreTake(handle, portMAX_DELAY); }
+    ~Guard() { xSemaphoreGive(handle); }
+  };
+
+  static void segmentPath(uint32_t segment, char* path, size_t size) {
+    snprintf(path, size, OUTBOX_DIR "/%08lu.log", (unsigned long)segment);
+  }
+
+  static size_t encode(const OutboxRecord& record, uint8_t* frame) {
+    size_t locationLength = strnlen(record.location, sizeof(record.location) - 1);
+    size_t itemLength = strnlen(record.item, sizeof(record.item) - 1);
+    uint8_t* payload = frame + sizeof(FrameHeader);
+    memcpy(payload, &record.epoch, 4);
+    memcpy(payload + 4, &record.boot, 2);
+    memcpy(payload + 6, &record.uptimeMs, 4);
+    payload[10] = record.dirty ? 1 : 0;
+    payload[11] = (uint8_t)locationLength;
+    payload[12] = (uint8_t)itemLength;
+    memcpy(payload + FIELDS, record.location, locationLength);
+    memcpy(payload + FIELDS + locationLength, record.item, itemLength);
+
+    FrameHeader header;
+    header.magic = FRAME_MAGIC;
+    header.length = (uint16_t)(FIELDS + locationLength + itemLength);
+    header.crc = CatalogFormat::crc32(payload, header.length);
+    memcpy(frame, &header, sizeof(header));
+    return sizeof(header) + header.length;
+  }
+
+  // Oude frames (alleen millis(), 7 bytes velden) blijven leesbaar
+  static bool decode(uint16_t magic, const uint8_t* payload, size_t length, OutboxRecord& record) {
+    size_t fields = magic == FRAME_MAGIC ? FIELDS : 7;
+    if (length < fields) return false;
+    size_t locationLength = payload[fields - 2];
+    size_t itemLength = payload[fields - 1];
+    if (fields + locationLength + itemLength != length ||
+        locationLength >= sizeof(record.location) || itemLength >= sizeof(record.item)) {
+      return false;
+    }
+    if (magic == FRAME_MAGIC) {
+      memcpy(&record.epoch, payload, 4);
+      memcpy(&record.boot, payload + 4, 2);
+      memcpy(&record.uptimeMs, payload + 6, 4);
+    } else {
+      record.epoch = 0;
+      record.boot = 0;
+      memcpy(&record.uptimeMs, payload, 4);
+    }
+    record.dirty = payload[fields - 3] != 0;
+    memcpy(record.location, payload + fields, locationLength);
+    record.location[locationLength] = '\0';
+    memcpy(record.item, payload + fields + locationLength, itemLength);
+    record.item[itemLength] = '\0';
+    return true;
+  }
+
+  // Volgend frame uit file; false aan het eind van het segment of bij een
+  // kapot frame (bad = true)
+  static bool readFrame(File& file, OutboxRecord& record, size_t& frameBytes, bool& bad) {
+    bad = false;
+    FrameHeader header;
+    size_t got = file.read((uint8_t*)&header, sizeof(header));
+    if (got == 0) return false;
+    uint8_t payload[MAX_PAYLOAD];
+    if (got != sizeof(header) || (header.magic != FRAME_MAGIC && header.magic != FRAME_MAGIC_MILLIS) ||
+        header.length > sizeof(payload) || file.read(payload, header.length) != header.length ||
+        CatalogFormat::crc32(payload, header.length) != header.crc ||
+        !decode(header.magic, payload, header.length, record)) {
+      bad = true;
+      return false;
+    }
+    frameBytes = sizeof(header) + header.length;
+    return true;
+  }
+
+  void writeCursor() {
+    CursorFile data;
+    data.position = cursor;
+    data.crc = CatalogFormat::crc32((const uint8_t*)&data.position, sizeof(data.position));
+    File file = LittleFS.open(OUTBOX_DIR "/cursor", "w");
+    if (!file) return;
+    file.write((const uint8_t*)&data, sizeof(data));
+    file.close();
+  }
+
+  bool readCursor(OutboxPosition& position) {
+    File file = LittleFS.open(OUTBOX_DIR "/cursor", "r");
+    if (!file) return false;
+    CursorFile data;
+    bool ok = file.read((uint8_t*)&data, sizeof(data)) == sizeof(data) &&
+              CatalogFormat::crc32((const uint8_t*)&data.position, sizeof(data.position)) == data.crc;
+    file.close();
+    if (ok) position = data.position;
+    return ok;
+  }
+
+  void removeSegment(uint32_t segment) {
+    char path[32];
+    segmentPath(segment, path, sizeof(path));
+    File file = LittleFS.open(path, "r");
+    if (!file) return;
+    size_t size = file.size();
+    file.close();
+    if (LittleFS.remove(path)) {
+      logBytes -= size < logBytes ? size : logBytes;
+      stats.segmentsRemoved++;
+    }
+  }
+
+  // Segmenten vóór de cursor weg; helemaal leeg = opnieuw beginnen in een
+  // vers segment (zodat het laatste ook weg kan)
+  void compact() {
+    if (depth == 0 && cursor != tail) {
+      cursor = tail;  // Alleen nog kapotte frames ertussen
+      writeCursor();
+    }
+    while (firstSegment < cursor.segment) removeSegment(firstSegment++);
+    if (depth == 0 && tail.offset > 0) {
+      removeSegment(tail.segment);
+      tail = {tail.segment + 1, 0};
+      cursor = tail;
+      firstSegment = tail.segment;
+      logBytes = 0;
+      writeCursor();
+    }
+  }
+
+  void advanceLocked(const OutboxPosition& next, size_t count) {
+    cursor = next;
+    depth -= count < depth ? count : depth;
+    writeCursor();
+    compact();
+    loadHead();
+  }
+
+  // Eerste leesbare record vanaf de cursor onthouden (leeftijd van de queue)
+  void loadHead() {
+    hasHead = false;
+    OutboxPosition position = cursor;
+    while (depth > 0 && position.segment <= tail.segment) {
+      char path[32];
+      segmentPath(position.segment, path, sizeof(path));
+      File file = LittleFS.open(path, "r");
+      if (file) {
+        file.seek(position.offset);
+        size_t frameBytes;
+        bool bad = false;
+        hasHead = readFrame(file, head, frameBytes, bad);
+        file.close();
+        if (hasHead) return;
+      }
+      position = {position.segment + 1, 0};
+    }
+  }
+
+  static uint32_t epochNow() {
+    time_t now = time(nullptr);
+    return now > 1600000000 ? (uint32_t)now : 0;  // Vóór 2020: SNTP nog niet binnen
+  }
+
+  OutboxRecord stamp(const char* location, const char* item, bool dirty) const {
+    OutboxRecord record;
+    record.epoch = epochNow();
+    record.uptimeMs = millis();
+    record.boot = boot;
+    record.dirty = dirty;
+    strlcpy(record.location, location, sizeof(record.location));
+    strlcpy(record.item, item, sizeof(record.item));
+    return record;
+  }
+
+  static uint32_t fileSize(const char* path) {
+    File file = LittleFS.open(path, "r");
+    if (!file) return 0;
+    uint32_t size = file.size();
+    file.close();
+    return size;
+  }
+
+  // Alle frames vanaf de cursor tellen (en controleren)
+  void scan() {
+    depth = 0;
+    OutboxPosition position = cursor;
+    while (position.segment <= tail.segment) {
+      char path[32];
+      segmentPath(position.segment, path, sizeof(path));
+      File file = LittleFS.open(path, "r");
+      if (file) {
+        file.seek(position.offset);
+        OutboxRecord record;
+        size_t frameBytes;
+        bool bad = false;
+        while (readFrame(file, record, frameBytes, bad)) depth++;
+        file.close();
+        if (bad) {
+          stats.crcErrors++;
+          Serial.printf("Outbox: bad frame in segment %lu, rest skipped\n",
+                        (unsigned long)position.segment);
+          // Niet achter een kapot frame verder schrijven
+          if (position.segment == tail.segment) tail = {tail.segment + 1, 0};
+        }
+      }
+      position = {position.segment + 1, 0};
+    }
+  }
+
+  // Oude JSON queue (van voor deze log) eenmalig overnemen
+  void migrateLegacyQueue() {
+    File file = LittleFS.open("/pending_posts.json", "r");
+    if (!file) return;
+    DynamicJsonDocument doc(8192);
+    DeserializationError error = deserializeJson(doc, file);
+    file.close();
+    if (!error) {
+      for (JsonObject post : doc["posts"].as<JsonArray>()) {
+        if (!appendLocked(stamp(post["location"] | "", post["item"] | "", post["dirty"] | false))) break;
+        stats.migrated++;
+      }
+    }
+    LittleFS.remove("/pending_posts.json");
+    Serial.printf("Outbox: migrated %u posts from /pending_posts.json\n", (unsigned)stats.migrated);
+  }
+
+  void beginLocked() {
+    if (ready) return;
+    if (!LittleFS.begin(true)) return;
+    LittleFS.mkdir(OUTBOX_DIR);
+    deadBytes = fileSize(OUTBOX_DIR "/dead");
+
+    Preferences prefs;
+    if (prefs.begin("outbox", false)) {
+      boot = prefs.getUShort("boot", 0) + 1;
+      prefs.putUShort("boot", boot);
+      prefs.end();
+    }
+
+    // Oudste en nieuwste segment zoeken
+    uint32_t lowest = UINT32_MAX;
+    uint32_t highest = 0;
+    logBytes = 0;
+    File dir = LittleFS.open(OUTBOX_DIR);
+    if (dir) {
+      File entry = dir.openNextFile();
+      while (entry) {
+        const char* name = entry.name();
+        const char* slash = strrchr(name, '/');
+        if (slash) name = slash + 1;
+        if (strstr(name, ".log")) {
+          uint32_t segment = strtoul(name, nullptr, 10);
+          if (segment > 0) {
+            if (segment < lowest) lowest = segment;
+            if (segment > highest) highest = segment;
+            logBytes += entry.size();
+          }
+        }
+        entry.close();
+        entry = dir.openNextFile();
+      }
+      dir.close();
+    }
+
+    OutboxPosition saved;
+    bool hasCursor = readCursor(saved);
+    if (highest == 0) {
+      // Geen segmenten: na de cursor verder nummeren
+      uint32_t next = hasCursor ? saved.segment + 1 : 1;
+      tail = cursor = {next, 0};
+      firstSegment = next;
+    } else {
+      char path[32];
+      segmentPath(highest, path, sizeof(path));
+      File file = LittleFS.open(path, "r");
+      tail = {highest, file ? (uint32_t)file.size() : 0};
+      if (file) file.close();
+      firstSegment = lowest;
+      // Onbruikbare cursor: alles opnieuw (dubbel versturen mag, kwijt niet)
+      cursor = hasCursor && saved.segment >= lowest ? saved : OutboxPosition{lowest, 0};
+      if (cursor.segment > tail.segment) cursor = tail;
+    }
+    ready = true;
+    scan();
+    migrateLegacyQueue();
+    compact();
+    loadHead();
+    Serial.printf("Outbox: %u pending, %u bytes in segments %lu..%lu\n", (unsigned)depth,
+                  (unsigned)logBytes, (unsigned long)firstSegment, (unsigned long)tail.segment);
+  }
+
+  bool appendLocked(const OutboxRecord& record) {
+    uint8_t frame[sizeof(FrameHeader) + MAX_PAYLOAD];
+    size_t length = encode(record, frame);
+    if (logBytes + length > OUTBOX_MAX_BYTES) {
+      stats.rejected++;
+      Serial.printf("Outbox full (%u bytes), selection dropped\n", (unsigned)logBytes);
+      return false;
+    }
+    if (tail.offset > 0 && tail.offset + length > OUTBOX_SEGMENT_BYTES) {
+      tail = {tail.segment + 1, 0};
+      stats.rotations++;
+    }
+
+    char path[32];
+    segmentPath(tail.segment, path, sizeof(path));
+    File file = LittleFS.open(path, "a");
+    if (!file) return false;
+    size_t written = file.write(frame, length);
+    file.close();  // LittleFS: pas na close staat het frame vast
+    if (written != length) {
+      // Half frame: dit segment niet meer gebruiken
+      tail = {tail.segment + 1, 0};
+      return false;
+    }
+    tail.offset += length;
+    logBytes += length;
+    depth++;
+    stats.appended++;
+    if (!hasHead) {
+      head = record;
+      hasHead = true;
+    }
+    return true;
+  }
+
+public:
+  static OutboxLog& getInstance() {
+    static OutboxLog instance;
+    return instance;
+  }
+
+  OutboxLog(const OutboxLog&) = delete;
+  void operator=(const OutboxLog&) = delete;
+
+  // Segmenten zoeken, frames tellen, cursor laden (gebeurt ook vanzelf bij
+  // het eerste gebruik)
+  void begin() {
+    Guard guard(lock);
+    beginLocked();
+  }
+
+  bool append(const char* location, const char* item, bool dirty) {
+    Guard guard(lock);
+    beginLocked();
+    return ready && appendLocked(stamp(location, item, dirty));
+  }
+
+  // Maximaal max records vanaf de cursor, allemaal voor dezelfde locatie
+  // (één batch). next = positie na het laatste record, voor commit().
+  size_t read(OutboxRecord* records, size_t max, OutboxPosition& next) {
+    Guard guard(lock);
+    beginLocked();
+    size_t count = 0;
+    OutboxPosition position = cursor;
+    while (count < max && depth > 0 && position != tail && position.segment <= tail.segment) {
+      char path[32];
+      segmentPath(position.segment, path, sizeof(path));
+      File file = LittleFS.open(path, "r");
+      if (file) {
+        file.seek(position.offset);
+        size_t frameBytes;
+        bool bad = false;
+        while (count < max && readFrame(file, records[count], frameBytes, bad)) {
+          if (count > 0 && strcmp(records[count].location, records[0].location) != 0) {
+            file.close();
+            next = position;
+            return count;
+          }
+          position.offset += frameBytes;
+          count++;
+        }
+        file.close();
+        if (count == max) break;
+      }
+      // Einde (of kapot stuk) van dit segment: verder in het volgende
+      if (position.segment == tail.segment) break;
+      position = {position.segment + 1, 0};
+    }
+    next = position;
+    return count;
+  }
+
+  // count records tot next zijn aangekomen: cursor vooruit (en bewaren)
+  void commit(const OutboxPosition& next, size_t count) {
+    Guard guard(lock);
+    advanceLocked(next, count);
+    stats.committed += count;
+  }
+
+  // Batch die de API blijvend weigert (uit read()): naar de dead file en
+  // voorbij de cursor, anders houdt hij elke latere selectie tegen. false
+  // als de dead file vol is of het schrijven mislukt; de cursor blijft dan
+  // staan (niets kwijt).
+  bool deadLetter(const OutboxRecord* records, size_t count, const OutboxPosition& next) {
+    Guard guard(lock);
+    std::vector<uint8_t> frames;
+    uint8_t frame[sizeof(FrameHeader) + MAX_PAYLOAD];
+    for (size_t i = 0; i < count; i++) {
+      size_t length = encode(records[i], frame);
+      frames.insert(frames.end(), frame, frame + length);
+    }
+    if (deadBytes + frames.size() > OUTBOX_DEAD_MAX_BYTES) {
+      Serial.printf("Outbox: dead file full (%u bytes), batch kept\n", (unsigned)deadBytes);
+      return false;
+    }
+    File file = LittleFS.open(OUTBOX_DIR "/dead", "a");
+    if (!file) return false;
+    size_t written = file.write(frames.data(), frames.size());
+    file.close();
+    deadBytes += written;
+    if (written != frames.size()) return false;
+
+    advanceLocked(next, count);
+    stats.deadLettered += count;
+    return true;
+  }
+
+  // Geweigerde selecties tonen ('outbox dead')
+  void printDead(Print& out) {
+    Guard guard(lock);
+    beginLocked();
+    File file = LittleFS.open(OUTBOX_DIR "/dead", "r");
+    if (!file) {
+      out.println("outbox dead: empty");
+      return;
+    }
+    OutboxRecord record;
+    size_t frameBytes;
+    bool bad = false;
+    size_t count = 0;
+    while (readFrame(file, record, frameBytes, bad)) {
+      out.printf("  %s / %s%s (boot %u, %lu ms, epoch %lu)\n", record.location, record.item,
+                 record.dirty ? " (vies)" : "", (unsigned)record.boot,
+                 (unsigned long)record.uptimeMs, (unsigned long)record.epoch);
+      count++;
+    }
+    file.close();
+    out.printf("outbox dead: %u records, %u bytes%s\n", (unsigned)count, (unsigned)deadBytes,
+               bad ? ", rest unreadable" : "");
+  }
+
+  // Geweigerde selecties terug in de log (bijv. na een fix op de API),
+  // met hun oorspronkelijke tijdstempels. Alleen als alles past; mislukt
+  // een append, dan blijft de dead file staan (dubbel mag, kwijt niet).
+  size_t replayDead() {
+    Guard guard(lock);
+    beginLocked();
+    if (!ready || deadBytes == 0) return 0;
+    if (logBytes + deadBytes > OUTBOX_MAX_BYTES) {
+      Serial.printf("Outbox: no room to replay %u dead bytes\n", (unsigned)deadBytes);
+      return 0;
+    }
+    File file = LittleFS.open(OUTBOX_DIR "/dead", "r");
+    if (!file) return 0;
+    OutboxRecord record;
+    size_t frameBytes;
+    bool bad = false;
+    size_t count = 0;
+    bool failed = false;
+    while (readFrame(file, record, frameBytes, bad)) {
+      if (!appendLocked(record)) {
+        failed = true;
+        break;
+      }
+      count++;
+    }
+    file.close();
+    if (!failed) {
+      LittleFS.remove(OUTBOX_DIR "/dead");
+      deadBytes = 0;
+    }
+    return count;
+  }
+
+  // Leeftijd van de oudste selectie in de queue. Over een reboot heen
+  // alleen als de klok (SNTP) bij het opslaan en nu gezet is; false als
+  // onbekend of als de queue leeg is.
+  bool oldestAgeMs(uint32_t& ageMs) {
+    Guard guard(lock);
+    if (!hasHead || depth == 0) return false;
+    uint32_t now = epochNow();
+    if (head.epoch && now) {
+      ageMs = now >= head.epoch ? (now - head.epoch) * 1000 : 0;
+      return true;
+    }
+    if (head.boot == boot && boot != 0) {
+      ageMs = millis() - head.uptimeMs;
+      return true;
+    }
+    return false;
+  }
+
+  uint32_t pending() const { return depth; }
+  uint32_t bytes() const { return logBytes; }
+  const Stats& getStats() const { return stats; }
+
+  void printStats(Print& out) {
+    Guard guard(lock);
+    out.printf("outbox log: %u pending, %u/%u bytes, segments %lu..%lu, cursor %lu:%lu, boot %u\n",
+               (unsigned)depth, (unsigned)logBytes, (unsigned)OUTBOX_MAX_BYTES,
+               (unsigned long)firstSegment, (unsigned long)tail.segment,
+               (unsigned long)cursor.segment, (unsigned long)cursor.offset, (unsigned)boot);
+    if (hasHead && depth > 0) {
+      out.printf("  oldest: boot %u at %lu ms, epoch %lu\n", (unsigned)head.boot,
+                 (unsigned long)head.uptimeMs, (unsigned long)head.epoch);
+    }
+    out.printf("  appended=%u committed=%u dead-lettered=%u rejected=%u crc errors=%u rotations=%u removed=%u\n",
+               (unsigned)stats.appended, (unsigned)stats.committed, (unsigned)stats.deadLettered,
+               (unsigned)stats.rejected, (unsigned)stats.crcErrors, (unsigned)stats.rotations,
+               (unsigned)stats.segmentsRemoved);
+    out.printf("  dead file: %u/%u bytes ('outbox dead', 'outbox replay')\n",
+               (unsigned)deadBytes, (unsigned)OUTBOX_DEAD_MAX_BYTES);
+  }
+};
+
+#endif
@@ -0,0 +1,167 @@
+#ifndef POPULARITY_SERVICE_H
+#define POPULARITY_SERVICE_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <math.h>
+#include "../config.h"
+#include "../models/Catalog.h"
+
+// Hoe vaak items hier gekozen worden, voor de "Vaak gekozen" pagina.
+// Alleen de POPULAR_TRACKED populairste items hebben een teller (Space-
+// Saving: een nieuw item vervangt de laagste). Tellers vervallen
+// exponentieel per selectie: in plaats van alle tellers te verlagen wordt
+// de stap steeds groter (en af en toe alles teruggeschaald). De tabel
+// blijft gesorteerd; een selectie schuift één item een paar plekken op,
+// geen volledige sortering.
+//
+// Checkpoint naar NVS: alleen als er iets veranderde en maximaal eens per
+// POPULAR_CHECKPOINT_MS, zodat de flash niet bij elke tik beschreven wordt.
+class PopularityService {
+public:
+  struct Entry {
+    int32_t id;
+    float score;
+  };
+
+  // Tikken (touch + swipe) op het home scherm tot een gekozen item, per
+  // stand van de "Vaak gekozen" pagina (uit = voor, aan = na)
+  struct TapStats {
+    uint32_t selections = 0;
+    uint32_t taps = 0;
+    uint32_t fromFrequentPage = 0;
+
+    float average() const { return selections ? (float)taps / selections : 0.0f; }
+  };
+
+private:
+  static constexpr float RESCALE_AT = 1e6f;
+
+  Entry entries[POPULAR_TRACKED];  // Hoogste score eerst
+  size_t count = 0;
+  float increment = 1.0f;
+  float growth;                    // 2^(1 / POPULAR_HALF_LIFE)
+  uint32_t changesSinceCheckpoint = 0;
+  uint32_t lastCheckpoint = 0;
+  uint32_t checkpoints = 0;
+  bool pageEnabled = POPULAR_PAGE_ENABLED;
+  TapStats tapStats[2];            // [0] = pagina uit, [1] = pagina aan
+
+  PopularityService() : growth(powf(2.0f, 1.0f / POPULAR_HALF_LIFE)) {}
+
+  // Entry i is gestegen: naar voren schuiven tot de volgorde weer klopt
+  void bubbleUp(size_t i) {
+    while (i > 0 && entries[i - 1].score < entries[i].score) {
+      Entry tmp = entries[i - 1];
+      entries[i - 1] = entries[i];
+      entries[i] = tmp;
+      i--;
+    }
+  }
+
+  void rescale() {
+    for (size_t i = 0; i < count; i++) entries[i].score /= increment;
+    increment = 1.0f;
+  }
+
+  void bump(int32_t id, float amount) {
+    size_t i = 0;
+    while (i < count && entries[i].id != id) i++;
+    if (i == count) {
+      if (count < POPULAR_TRACKED) {
+        entries[count++] = {id, 0.0f};
+      } else {
+        // Vervang de laagste; die score blijft staan (Space-Saving)
+        i = count - 1;
+        entries[i].id = id;
+      }
+    }
+    entries[i].score += amount;
+    bubbleUp(i);
+    changesSinceCheckpoint++;
+  }
+
+public:
+  static PopularityService& getInstance() {
+    static PopularityService instance;
+    return instance;
+  }
+
+  PopularityService(const PopularityService&) = delete;
+  void operator=(const PopularityService&) = delete;
+
+  void recordSelection(int32_t id) {
+    increment *= growth;
+    if (increment > RESCALE_AT) rescale();
+    bump(id, increment);
+  }
+
+  // Slots (in catalogus volgorde) van de populairste items die in deze
+  // catalogus staan; max slots
+  size_t topSlots(const Catalog& catalog, uint16_t* slots, size_t max) const {
+    size_t n = 0;
+    for (size_t i = 0; i < count && n < max; i++) {
+      const Item* item = catalog.findById(entries[i].id);
+      if (item) slots[n++] = item - catalog.all().begin();
+    }
+    return n;
+  }
+
+  void recordTaps(uint32_t taps, bool fromFrequentPage) {
+    TapStats& stats = tapStats[pageEnabled ? 1 : 0];
+    stats.selections++;
+    stats.taps += taps;
+    if (fromFrequentPage) stats.fromFrequentPage++;
+  }
+
+  bool isPageEnabled() const { return pageEnabled; }
+  void setPageEnabled(bool enabled) { pageEnabled = enabled; }
+  bool empty() const { return count == 0; }
+
+  // ========== NVS ==========
+
+  void load() {
+    Preferences prefs;
+    if (!prefs.begin("popular", true)) return;
+    size_t bytes = prefs.getBytes("entries", entries, sizeof(entries));
+    count = bytes / sizeof(Entry);
+    increment = prefs.getFloat("increment", 1.0f);
+    prefs.end();
+    if (increment < 1.0f) increment = 1.0f;
+    Serial.printf("Popularity: %u items loaded\n", (unsigned)count);
+  }
+
+  // Periodiek aanroepen; schrijft alleen als het nodig is
+  void checkpoint(bool force = false) {
+    if (changesSinceCheckpoint == 0) return;
+    if (!force && millis() - lastCheckpoint < POPULAR_CHECKPOINT_MS) return;
+
+    Preferences prefs;
+    if (!prefs.begin("popular", false)) return;
+    prefs.putBytes("entries", entries, count * sizeof(Entry));
+    prefs.putFloat("increment", increment);
+    prefs.end();
+    changesSinceCheckpoint = 0;
+    lastCheckpoint = millis();
+    checkpoints++;
+  }
+
+  void printStats(Print& out, const Catalog& catalog) const {
+    out.printf("Popularity: %u/%u items, page %s, %u checkpoints (%u changes pending)\n",
+               (unsigned)count, (unsigned)POPULAR_TRACKED, pageEnabled ? "on" : "off",
+               (unsigned)checkpoints, (unsigned)changesSinceCheckpoint);
+    for (size_t i = 0; i < count && i < 10; i++) {
+      const Item* item = catalog.findById(entries[i].id);
+      out.printf("  %2u. %-24s %6.2f\n", (unsigned)(i + 1),
+                 item ? catalog.nameOf(*item) : "(niet in catalogus)", entries[i].score / increment);
+    }
+    static const char* labels[] = {"page off", "page on "};
+    for (int i = 0; i < 2; i++) {
+      const TapStats& stats = tapStats[i];
+      out.printf("  %s: %u selections, %.2f taps avg, %u from frequent page\n", labels[i],
+                 (unsigned)stats.selections, stats.average(), (unsigned)stats.fromFrequentPage);
+    }
+  }
+};
+
+#endif
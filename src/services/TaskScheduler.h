@@ -0,0 +1,211 @@
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include <Arduino.h>
+#include <functional>
+#include <vector>
+#include "../diagnostics/Tracer.h"
+#include "../diagnostics/LoopProfiler.h"
+
+// Cooperative deadline scheduler voor de main loop.
+// Elke taak heeft een eigen periode, deadline en prioriteit. Taken met
+// periode 0 draaien alleen na trigger() (bijv. render na invalidatie).
+using TaskCallback = std::function<void()>;
+
+struct ScheduledTask {
+  const char* name;
+  TaskCallback callback;
+  uint32_t periodUs;        // 0 = alleen op trigger()
+  uint32_t deadlineUs;      // Max start-vertraging na due tijd
+  uint8_t priority;         // Hoger = eerder in dezelfde ronde
+  int profileStage;         // LoopProfiler stage id
+  bool enabled;
+  bool triggered;
+  uint32_t triggeredAtUs;   // Eerste trigger() sinds de laatste run
+  uint32_t nextDueUs;
+
+  // Statistieken
+  uint32_t runs;
+  uint32_t overruns;        // Looptijd langer dan de eigen periode
+  uint32_t missedDeadlines; // Te laat gestart
+  uint32_t lastDurationUs;
+  uint32_t maxDurationUs;
+  uint32_t maxLatencyUs;
+  uint64_t totalDurationUs;
+};
+
+class TaskScheduler {
+private:
+  std::vector<ScheduledTask> tasks;
+  std::vector<uint8_t> order;   // Task ids gesorteerd op prioriteit
+  uint64_t idleUs = 0;
+  uint32_t statsSinceUs = 0;
+  int idleStage = -1;
+
+  // Wrap-veilig: true als a op of na b ligt
+  static bool reached(uint32_t now, uint32_t due) {
+    return (int32_t)(now - due) >= 0;
+  }
+
+  bool isDue(const ScheduledTask& t, uint32_t now) const {
+    if (!t.enabled) return false;
+    if (t.triggered) return true;
+    return t.periodUs > 0 && reached(now, t.nextDueUs);
+  }
+
+  void runTask(ScheduledTask& t, uint32_t now) {
+    // Start-vertraging t.o.v. de trigger of anders de due tijd
+    uint32_t latency = 0;
+    if (t.triggered) {
+      latency = now - t.triggeredAtUs;
+    } else if (t.periodUs > 0) {
+      latency = now - t.nextDueUs;
+    }
+    if (latency > t.maxLatencyUs) t.maxLatencyUs = latency;
+    if (t.deadlineUs > 0 && latency > t.deadlineUs) t.missedDeadlines++;
+
+    t.triggered = false;
+    uint32_t startCycles = LoopProfiler::now();
+    t.callback();
+    LoopProfiler::getInstance().record(t.profileStage, LoopProfiler::now() - startCycles);
+
+    uint32_t end = micros();
+    uint32_t duration = end - now;
+    t.runs++;
+    t.lastDurationUs = duration;
+    t.totalDurationUs += duration;
+    if (duration > t.maxDurationUs) t.maxDurationUs = duration;
+    if (t.periodUs > 0 && duration > t.periodUs) t.overruns++;
+
+    if (t.periodUs > 0) {
+      t.nextDueUs += t.periodUs;
+      // Te ver achter: niet inhalen, maar opnieuw vanaf nu plannen
+      if (reached(end, t.nextDueUs)) {
+        t.nextDueUs = end + t.periodUs;
+      }
+    }
+  }
+
+  TaskScheduler() {}
+
+public:
+  static TaskScheduler& getInstance() {
+    static TaskScheduler instance;
+    return instance;
+  }
+
+  TaskScheduler(const TaskScheduler&) = delete;
+  void operator=(const TaskScheduler&) = delete;
+
+  // Registreer een taak; geeft task id terug
+  int addTask(const char* name, uint32_t periodMs, uint32_t deadlineMs,
+              uint8_t priority, TaskCallback callback) {
+    ScheduledTask t = {};
+    t.name = name;
+    t.callback = callback;
+    t.periodUs = periodMs * 1000;
+    t.deadlineUs = deadlineMs * 1000;
+    t.priority = priority;
+    t.enabled = true;
+    t.triggered = false;
+    t.nextDueUs = micros() + t.periodUs;
+    t.profileStage = LoopProfiler::getInstance().addStage(name);
+    tasks.push_back(t);
+
+    int id = tasks.size() - 1;
+    order.push_back(id);
+    std::stable_sort(order.begin(), order.end(), [this](uint8_t a, uint8_t b) {
+      return tasks[a].priority > tasks[b].priority;
+    });
+
+    Serial.printf("Scheduler: task '%s' period=%lums prio=%d\n",
+                  name, (unsigned long)periodMs, priority);
+    return id;
+  }
+
+  // Laat een taak in de volgende ronde draaien (invalidatie). Latency telt
+  // vanaf de eerste trigger; latere triggers voor dezelfde run niet.
+  void trigger(int id) {
+    if (id >= 0 && id < (int)tasks.size() && !tasks[id].triggered) {
+      tasks[id].triggered = true;
+      tasks[id].triggeredAtUs = micros();
+    }
+  }
+
+  void setEnabled(int id, bool enabled) {
+    if (id >= 0 && id < (int)tasks.size()) {
+      tasks[id].enabled = enabled;
+      tasks[id].nextDueUs = micros() + tasks[id].periodUs;
+    }
+  }
+
+  // Eén ronde: alle due taken op prioriteit, daarna slapen tot de volgende
+  void run() {
+    for (uint8_t id : order) {
+      ScheduledTask& t = tasks[id];
+      uint32_t now = micros();
+      if (isDue(t, now)) {
+        runTask(t, now);
+      }
+    }
+
+    // Getriggerd tijdens deze ronde? Dan niet slapen.
+    uint32_t now = micros();
+    uint32_t sleepUs = UINT32_MAX;
+    for (const auto& t : tasks) {
+      if (!t.enabled) continue;
+      if (t.triggered) return;
+      if (t.periodUs == 0) continue;
+      if (reached(now, t.nextDueUs)) return;
+      uint32_t until = t.nextDueUs - now;
+      if (until < sleepUs) sleepUs = until;
+    }
+    if (sleepUs == UINT32_MAX) sleepUs = 1000;
+
+    // delay() geeft de CPU terug aan FreeRTOS (1 ms ticks)
+    uint32_t sleepMs = sleepUs / 1000;
+    if (sleepMs > 0) {
+      TRACE_SCOPE(TraceName::SCHEDULER_IDLE);
+      if (idleStage < 0) {
+        idleStage = LoopProfiler::getInstance().addStage("idle");
+      }
+      uint32_t startCycles = LoopProfiler::now();
+      delay(sleepMs);
+      LoopProfiler::getInstance().record(idleStage, LoopProfiler::now() - startCycles);
+      idleUs += micros() - now;
+    }
+  }
+
+  void resetStats() {
+    for (auto& t : tasks) {
+      t.runs = 0;
+      t.overruns = 0;
+      t.missedDeadlines = 0;
+      t.maxDurationUs = 0;
+      t.maxLatencyUs = 0;
+      t.totalDurationUs = 0;
+    }
+    idleUs = 0;
+    statsSinceUs = micros();
+  }
+
+  void printStats(Print& out) const {
+    uint32_t window = micros() - statsSinceUs;
+    out.printf("%-10s %7s %6s %8s %8s %8s %6s %6s\n",
+               "task", "period", "runs", "avg_us", "max_us", "lat_us", "ovr", "miss");
+    for (const auto& t : tasks) {
+      uint32_t avg = t.runs ? (uint32_t)(t.totalDurationUs / t.runs) : 0;
+      out.printf("%-10s %5lums %6lu %8lu %8lu %8lu %6lu %6lu%s\n",
+                 t.name, (unsigned long)(t.periodUs / 1000), (unsigned long)t.runs,
+                 (unsigned long)avg, (unsigned long)t.maxDurationUs,
+                 (unsigned long)t.maxLatencyUs, (unsigned long)t.overruns,
+                 (unsigned long)t.missedDeadlines, t.enabled ? "" : " (off)");
+    }
+    out.printf("idle: %.1f%%\n", window ? 100.0 * idleUs / window : 0.0);
+  }
+
+  const std::vector<ScheduledTask>& getTasks() const { return tasks; }
+  uint64_t getIdleUs() const { return idleUs; }
+};
+
+#endif
@@ -0,0 +1,321 @@
+#ifndef WIFI_MANAGER_H
+#define WIFI_MANAGER_H
+
+#include <WiFi.h>
+#include <Preferences.h>
+#include "../config.h"
+#include "../events/Event.h"
+
+// Event-driven WiFi verbinding met reconnect state machine.
+// ESP32 WiFi events (system event task) zetten alleen vlaggen; update()
+// op de UI thread doet de state overgangen en dispatcht WIFI_* events.
+
+enum class WiFiState : uint8_t {
+  IDLE,
+  CONNECTING,
+  CONNECTED,
+  BACKOFF
+};
+
+struct WiFiStats {
+  uint32_t attempts = 0;
+  uint32_t successes = 0;
+  uint32_t fastConnects = 0;    // Gelukt met gecachte BSSID/kanaal
+  uint32_t failures = 0;
+  uint32_t disconnects = 0;
+  uint32_t lastConnectMs = 0;
+  uint32_t minConnectMs = 0;
+  uint32_t maxConnectMs = 0;
+  uint64_t totalConnectMs = 0;
+  uint8_t lastDisconnectReason = 0;
+};
+
+class WiFiManager {
+private:
+  WiFiState state = WiFiState::IDLE;
+  WiFiStats stats;
+
+  // Gezet vanuit de WiFi event callback; disconnect gegevens en BSSID
+  // onder eventLock (meerdere velden tegelijk)
+  portMUX_TYPE eventLock = portMUX_INITIALIZER_UNLOCKED;
+  volatile bool linkUp = false;
+  volatile bool gotIpFlag = false;
+  bool disconnectedFlag = false;
+  uint8_t disconnectReason = 0;
+  uint32_t disconnectGeneration = 0;  // Poging waarin de disconnect binnenkwam
+  uint8_t eventBssid[6] = {0};
+  uint8_t eventChannel = 0;
+
+  // Elke poging een eigen generatie. WiFi.disconnect() na een mislukte
+  // poging geeft een asynchrone STA_DISCONNECTED (ASSOC_LEAVE) die pas
+  // tijdens de volgende poging binnen kan komen; die hoort bij leftGeneration
+  // en mag de nieuwe poging niet laten mislukken.
+  volatile uint32_t attemptGeneration = 0;
+  uint32_t leftGeneration = 0;        // Door ons afgebroken poging (0 = geen)
+
+  // Gecachte AP gegevens voor snelle reconnect (NVS)
+  uint8_t cachedBssid[6] = {0};
+  uint8_t cachedChannel = 0;
+  bool usingCache = false;
+
+  unsigned long attemptStart = 0;
+  unsigned long backoffUntil = 0;
+  uint32_t backoffMs = WIFI_BACKOFF_MIN_MS;
+
+  WiFiManager() {}
+
+  void onWiFiEvent(arduino_event_id_t event, arduino_event_info_t info) {
+    switch (event) {
+      case ARDUINO_EVENT_WIFI_STA_CONNECTED:
+        portENTER_CRITICAL(&eventLock);
+        memcpy(eventBssid, info.wifi_sta_connected.bssid, 6);
+        eventChannel = info.wifi_sta_connected.channel;
+        portEXIT_CRITICAL(&eventLock);
+        break;
+      case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+        linkUp = true;
+        gotIpFlag = true;
+        break;
+      case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+        linkUp = false;
+        portENTER_CRITICAL(&eventLock);
+        disconnectReason = info.wifi_sta_disconnected.reason;
+        disconnectGeneration = attemptGeneration;
+        disconnectedFlag = true;
+        portEXIT_CRITICAL(&eventLock);
+        break;
+      default:
+        break;
+    }
+  }
+
+  void loadApCache() {
+    Preferences prefs;
+    if (!prefs.begin("wifi", true)) return;
+    cachedChannel = prefs.getUChar("channel", 0);
+    if (prefs.getBytes("bssid", cachedBssid, sizeof(cachedBssid)) != sizeof(cachedBssid)) {
+      cachedChannel = 0;
+    }
+    prefs.end();
+  }
+
+  // Disconnect van de event taak ophalen (en wissen); false als er geen was
+  bool takeDisconnect(uint8_t& reason, uint32_t& generation) {
+    portENTER_CRITICAL(&eventLock);
+    bool flag = disconnectedFlag;
+    reason = disconnectReason;
+    generation = disconnectGeneration;
+    disconnectedFlag = false;
+    portEXIT_CRITICAL(&eventLock);
+    return flag;
+  }
+
+  // Echo van onze eigen WiFi.disconnect() voor de vorige poging
+  bool isOwnLeave(uint8_t reason, uint32_t generation) {
+    if (reason != WIFI_REASON_ASSOC_LEAVE || leftGeneration == 0 ||
+        generation != leftGeneration + 1) {
+      return false;
+    }
+    leftGeneration = 0;  // Er komt er maar één
+    return true;
+  }
+
+  void saveApCache() {
+    uint8_t bssid[6];
+    portENTER_CRITICAL(&eventLock);
+    memcpy(bssid, eventBssid, 6);
+    uint8_t channel = eventChannel;
+    portEXIT_CRITICAL(&eventLock);
+    if (channel == cachedChannel && memcmp(bssid, cachedBssid, 6) == 0) {
+      return;  // Ongewijzigd - geen NVS write
+    }
+    memcpy(cachedBssid, bssid, 6);
+    cachedChannel = channel;
+
+    Preferences prefs;
+    if (!prefs.begin("wifi", false)) return;
+    prefs.putBytes("bssid", cachedBssid, sizeof(cachedBssid));
+    prefs.putUChar("channel", cachedChannel);
+    prefs.end();
+    Serial.printf("WiFi: cached AP %02X:%02X:%02X:%02X:%02X:%02X ch %d\n",
+                  cachedBssid[0], cachedBssid[1], cachedBssid[2],
+                  cachedBssid[3], cachedBssid[4], cachedBssid[5], cachedChannel);
+  }
+
+  void clearApCache() {
+    cachedChannel = 0;
+    Preferences prefs;
+    if (!prefs.begin("wifi", false)) return;
+    prefs.remove("channel");
+    prefs.end();
+  }
+
+  void startAttempt() {
+    stats.attempts++;
+    attemptStart = millis();
+    gotIpFlag = false;
+    // Kwam de echo van onze eigen disconnect al (tijdens de backoff), dan
+    // hoeft de nieuwe poging er niet meer op te letten
+    uint8_t reason;
+    uint32_t generation;
+    if (takeDisconnect(reason, generation) && generation == leftGeneration) leftGeneration = 0;
+    attemptGeneration++;
+    state = WiFiState::CONNECTING;
+
+    // Gecachte BSSID + kanaal slaat de volledige scan over
+    usingCache = cachedChannel != 0;
+    if (usingCache) {
+      WiFi.begin(WIFI_SSID, WIFI_PASS, cachedChannel, cachedBssid);
+    } else {
+      WiFi.begin(WIFI_SSID, WIFI_PASS);
+    }
+    Serial.printf("WiFi: attempt %u (%s)\n", stats.attempts,
+                  usingCache ? "cached AP" : "full scan");
+  }
+
+  void onAttemptFailed(uint8_t reason) {
+    stats.failures++;
+    leftGeneration = attemptGeneration;
+    WiFi.disconnect();
+
+    // Snelle reconnect mislukt: AP is mogelijk verhuisd, volgende keer scannen
+    if (usingCache) {
+      clearApCache();
+    }
+
+    // Exponential backoff met jitter (0..50%)
+    uint32_t jitter = esp_random() % (backoffMs / 2 + 1);
+    backoffUntil = millis() + backoffMs + jitter;
+    Serial.printf("WiFi: attempt failed (reason %d), retry in %u ms\n",
+                  reason, backoffMs + jitter);
+    backoffMs = backoffMs * 2 > WIFI_BACKOFF_MAX_MS ? WIFI_BACKOFF_MAX_MS : backoffMs * 2;
+    state = WiFiState::BACKOFF;
+  }
+
+  void onConnected() {
+    uint32_t connectMs = millis() - attemptStart;
+    stats.successes++;
+    if (usingCache) stats.fastConnects++;
+    stats.lastConnectMs = connectMs;
+    stats.totalConnectMs += connectMs;
+    if (stats.minConnectMs == 0 || connectMs < stats.minConnectMs) stats.minConnectMs = connectMs;
+    if (connectMs > stats.maxConnectMs) stats.maxConnectMs = connectMs;
+
+    backoffMs = WIFI_BACKOFF_MIN_MS;
+    state = WiFiState::CONNECTED;
+    saveApCache();
+    configTime(0, 0, NTP_SERVER);  // UTC; op de achtergrond (tijdstempels outbox)
+
+    Serial.printf("WiFi connected in %u ms, IP: %s\n", connectMs,
+                  WiFi.localIP().toString().c_str());
+
+    Event event;
+    event.type = EventType::WIFI_CONNECTED;
+    event.param1 = connectMs;
+    EventBus::getInstance().dispatch(event);
+  }
+
+  void onDisconnected(uint8_t reason) {
+    stats.disconnects++;
+    stats.lastDisconnectReason = reason;
+    Serial.printf("WiFi disconnected (reason %d)\n", reason);
+
+    Event event;
+    event.type = EventType::WIFI_DISCONNECTED;
+    event.param1 = reason;
+    EventBus::getInstance().dispatch(event);
+
+    // Direct opnieuw proberen; backoff pas na een mislukte poging
+    startAttempt();
+  }
+
+public:
+  static WiFiManager& getInstance() {
+    static WiFiManager instance;
+    return instance;
+  }
+
+  WiFiManager(const WiFiManager&) = delete;
+  void operator=(const WiFiManager&) = delete;
+
+  // Start verbinden; blokkeert niet
+  void begin() {
+    Serial.printf("WiFi: SSID %s\n", WIFI_SSID);
+
+    WiFi.persistent(false);       // Geen flash write bij elke begin()
+    WiFi.mode(WIFI_STA);
+    WiFi.setAutoReconnect(false); // Reconnect doet de state machine
+    WiFi.onEvent([this](arduino_event_id_t event, arduino_event_info_t info) {
+      onWiFiEvent(event, info);
+    });
+
+#ifdef WIFI_STATIC_IP
+    // Statisch IP slaat DHCP over
+    IPAddress ip, gateway, subnet, dns;
+    ip.fromString(WIFI_STATIC_IP);
+    gateway.fromString(WIFI_GATEWAY);
+    subnet.fromString(WIFI_SUBNET);
+    dns.fromString(WIFI_DNS);
+    WiFi.config(ip, gateway, subnet, dns);
+#endif
+
+    loadApCache();
+    startAttempt();
+  }
+
+  // Aanroepen vanuit de scheduler (UI thread)
+  void update() {
+    switch (state) {
+      case WiFiState::IDLE:
+        break;
+
+      case WiFiState::CONNECTING: {
+        uint8_t reason;
+        uint32_t generation;
+        if (gotIpFlag) {
+          gotIpFlag = false;
+          onConnected();
+        } else if (takeDisconnect(reason, generation) && !isOwnLeave(reason, generation)) {
+          onAttemptFailed(reason);
+        } else if (millis() - attemptStart > WIFI_CONNECT_TIMEOUT_MS) {
+          onAttemptFailed(0);
+        }
+        break;
+      }
+
+      case WiFiState::CONNECTED: {
+        uint8_t reason;
+        uint32_t generation;
+        if (takeDisconnect(reason, generation) && !isOwnLeave(reason, generation)) {
+          onDisconnected(reason);
+        }
+        break;
+      }
+
+      case WiFiState::BACKOFF:
+        if ((long)(millis() - backoffUntil) >= 0) {
+          startAttempt();
+        }
+        break;
+    }
+  }
+
+  // Veilig vanaf beide cores
+  bool isConnected() const { return linkUp; }
+  WiFiState getState() const { return state; }
+  const WiFiStats& getStats() const { return stats; }
+
+  void printStats(Print& out) const {
+    static const char* const names[] = {"idle", "connecting", "connected", "backoff"};
+    out.printf("wifi: %s, rssi=%d dBm, ch=%d\n", names[(int)state],
+               linkUp ? WiFi.RSSI() : 0, cachedChannel);
+    out.printf("attempts=%u ok=%u fast=%u failed=%u disconnects=%u last_reason=%d\n",
+               stats.attempts, stats.successes, stats.fastConnects, stats.failures,
+               stats.disconnects, stats.lastDisconnectReason);
+    uint32_t avg = stats.successes ? (uint32_t)(stats.totalConnectMs / stats.successes) : 0;
+    out.printf("connect ms: last=%u min=%u avg=%u max=%u, backoff=%u\n",
+               stats.lastConnectMs, stats.minConnectMs, avg, stats.maxConnectMs, backoffMs);
+  }
+};
+
+#endif
@@ -5,30 +5,92 @@
 #include "../display/DisplayManager.h"
 #include "../models/Item.h"
 #include "../models/ItemRepository.h"
+#include "../models/ItemSearch.h"
+#include "../services/PopularityService.h"
 #include "../input/TouchInputManager.h"
-#include <vector>
 
 enum class HomeScreenMode {
   GRID,
   DIRTY_POPUP,
-  RESULT
+  RESULT,
+  LETTERS,      // A-Z paneel over de grid
+  SEARCH        // Toetsenbord + treffers
 };
 
 class HomeScreen : public ScreenState {
 private:
   DisplayManager* display;
-  std::vector<Item> allItems;
   int scrollOffset = 0;
   int selectedItemIndex = -1;
+  bool selectedDirty = false;   // Schoon/vies keuze van deze sessie
   bool needsRedraw = true;
+  bool gridDirty = false;       // Alleen header + content (pagina wissel, letter sprong)
   
   HomeScreenMode mode = HomeScreenMode::GRID;
   int pendingItemIndex = -1;
+  uint32_t loadedVersion = 0;
 
-  void loadAllItems() {
+  // Zoeken
+  ItemSearch search;
+  char searchQuery[SEARCH_QUERY_MAX + 1] = "";
+  size_t searchLength = 0;
+  size_t searchOffset = 0;                   // Eerste zichtbare treffer
+  int shownSlots[SEARCH_RESULT_CELLS];       // Wat nu in elke cel staat, -1 = leeg
+
+  // "Vaak gekozen" pagina, vóór de A-Z pagina's
+  bool onFrequentPage = false;
+  uint16_t frequentSlots[ITEMS_PER_PAGE];
+  size_t frequentCount = 0;
+  uint32_t sessionTaps = 0;                  // Tikken sinds het begin van deze keuze
+  bool pickedFromFrequent = false;
+
+  // Zero-copy view; altijd vers opvragen zodat een catalogus swap veilig is
+  ItemSpan items() const {
+    return ItemRepository::getInstance().getAllItems();
+  }
+
+  const char* nameOf(const Item& item) const {
+    return ItemRepository::getInstance().nameOf(item);
+  }
+
+  // Na een catalogus wissel kloppen indexen niet meer: terug naar de grid
+  void syncCatalog() {
     ItemRepository& repo = ItemRepository::getInstance();
-    allItems = repo.getAllItems();
-    Serial.printf("Loaded %d items (sorted A-Z)\n", allItems.size());
+    if (loadedVersion == repo.getVersion()) return;
+    loadedVersion = repo.getVersion();
+
+    if (scrollOffset >= (int)items().size()) {
+      scrollOffset = 0;
+    }
+    mode = HomeScreenMode::GRID;
+    selectedItemIndex = -1;
+    pendingItemIndex = -1;
+    needsRedraw = true;
+    refreshFrequent();
+    Serial.printf("HomeScreen: catalog v%u, %d items\n", loadedVersion, items().size());
+  }
+
+  bool hasFrequentPage() const {
+    return frequentCount > 0 && PopularityService::getInstance().isPageEnabled();
+  }
+
+  // Top items opnieuw opzoeken (na een selectie of catalogus wissel);
+  // de volgorde houdt PopularityService al bij
+  void refreshFrequent() {
+    frequentCount = PopularityService::getInstance().topSlots(
+      ItemRepository::getInstance().getCatalog(), frequentSlots, ITEMS_PER_PAGE);
+    if (!hasFrequentPage()) onFrequentPage = false;
+  }
+
+  IndexedItemRange frequentItems() const {
+    return IndexedItemRange(items().begin(), frequentSlots, frequentCount);
+  }
+
+  // Nieuwe keuze begint op de "Vaak gekozen" pagina (als die er is)
+  void startSession() {
+    refreshFrequent();
+    onFrequentPage = hasFrequentPage();
+    sessionTaps = 0;
   }
 
   // Simpele grid touch - welk item is aangeklikt?
@@ -58,14 +120,18 @@ private:
     
     // Bereken item index
     int gridIndex = row * GRID_ITEM_COLS + col;
+    if (onFrequentPage) {
+      if (gridIndex >= (int)frequentCount || frequentSlots[gridIndex] >= items().size()) return -1;
+      return frequentSlots[gridIndex];
+    }
     int actualIndex = scrollOffset + gridIndex;
     
     Serial.printf("Touch->Grid: x=%d,y=%d -> col=%d,row=%d -> grid=%d + offset=%d = actual=%d\n",
                   x, y, col, row, gridIndex, scrollOffset, actualIndex);
     
     // Check of dit item bestaat
-    if (actualIndex >= 0 && actualIndex < (int)allItems.size()) {
-      Serial.printf("Item found: %s\n", allItems[actualIndex].name.c_str());
+    if (actualIndex >= 0 && actualIndex < (int)items().size()) {
+      Serial.printf("Item found: %s\n", nameOf(items()[actualIndex]));
       return actualIndex;
     }
     Serial.println("Index out of bounds!");
@@ -73,19 +139,24 @@ private:
   }
 
   void handleGridClick(int x, int y) {
-    int itemIndex = getItemAtPosition(x, y);
-    
-    if (itemIndex >= 0) {
-      Item& item = allItems[itemIndex];
+    pickedFromFrequent = onFrequentPage;
+    selectItem(getItemAtPosition(x, y));
+  }
+
+  // Gedeeld door grid en zoek treffers: index = slot in de catalogus
+  void selectItem(int itemIndex) {
+    if (itemIndex >= 0 && itemIndex < (int)items().size()) {
+      const Item& item = items()[itemIndex];
       selectedItemIndex = itemIndex;
       
       Serial.printf("Item clicked: %s (idx=%d, canBeDirty=%d)\n", 
-                    item.name.c_str(), itemIndex, item.canBeDirty);
+                    nameOf(item), itemIndex, item.canBeDirty);
       
       if (item.canBeDirty) {
         pendingItemIndex = itemIndex;
         mode = HomeScreenMode::DIRTY_POPUP;
       } else {
+        selectedDirty = false;
         dispatchItemEvent(item, false);
         mode = HomeScreenMode::RESULT;
       }
@@ -94,11 +165,11 @@ private:
   }
 
   void handlePopupClick(int x, int y) {
-    if (pendingItemIndex < 0 || pendingItemIndex >= (int)allItems.size()) return;
+    if (pendingItemIndex < 0 || pendingItemIndex >= (int)items().size()) return;
     
     Serial.printf("Popup click: x=%d, y=%d\n", x, y);
     
-    Item& item = allItems[pendingItemIndex];
+    const Item& item = items()[pendingItemIndex];
     
     // Simpele verdeling: bovenste helft = schoon, onderste helft = vies
     // Header is 60px, dus content start bij y=60
@@ -108,7 +179,7 @@ private:
     if (y >= 60 && y < 190) {
       // Bovenste helft - SCHOON
       Serial.println("SCHOON button pressed!");
-      item.isDirty = false;
+      selectedDirty = false;
       dispatchItemEvent(item, false);
       mode = HomeScreenMode::RESULT;
       needsRedraw = true;
@@ -118,7 +189,7 @@ private:
     if (y >= 190) {
       // Onderste helft - VIES
       Serial.println("VIES button pressed!");
-      item.isDirty = true;
+      selectedDirty = true;
       dispatchItemEvent(item, true);
       mode = HomeScreenMode::RESULT;
       needsRedraw = true;
@@ -129,12 +200,17 @@ private:
   }
 
   void dispatchItemEvent(const Item& item, bool isDirty) {
+    PopularityService::getInstance().recordTaps(sessionTaps, pickedFromFrequent);
+    Serial.printf("Selected after %u taps%s\n", (unsigned)sessionTaps,
+                  pickedFromFrequent ? " (frequent page)" : "");
+    sessionTaps = 0;
+
     Event event;
     event.type = EventType::ITEM_SELECTED;
     event.param1 = item.id;
     event.param2 = isDirty ? 1 : 0;  // Stuur isDirty mee!
     EventBus::getInstance().dispatch(event);
-    Serial.printf("Event: item %d (%s), dirty=%d\n", item.id, item.name.c_str(), isDirty);
+    Serial.printf("Event: item %d (%s), dirty=%d\n", item.id, nameOf(item), isDirty);
   }
 
   void returnToGrid() {
@@ -142,6 +218,7 @@ private:
     selectedItemIndex = -1;
     pendingItemIndex = -1;
     needsRedraw = true;
+    startSession();
     
     // LEDs uit wanneer terug naar grid
     Event ledOffEvent;
@@ -150,26 +227,187 @@ private:
     EventBus::getInstance().dispatch(ledOffEvent);
   }
 
+  // Letter bucket van het eerste item op de huidige pagina
+  int getCurrentLetterBucket() {
+    const Catalog& catalog = ItemRepository::getInstance().getCatalog();
+    for (int b = 0; b < Catalog::LETTER_BUCKETS; b++) {
+      if ((size_t)scrollOffset < catalog.letterOffset(b) + catalog.letterCount(b)) return b;
+    }
+    return -1;
+  }
+
+  // Moet matchen met DisplayManager::drawLetterPanel
+  int getLetterBucketAtPosition(int x, int y) {
+    int contentHeight = PORTRAIT_HEIGHT - HEADER_HEIGHT - FOOTER_HEIGHT;
+    int col = x / (PORTRAIT_WIDTH / LETTER_PANEL_COLS);
+    int row = (y - HEADER_HEIGHT) / (contentHeight / LETTER_PANEL_ROWS);
+    if (col < 0 || col >= LETTER_PANEL_COLS || row < 0 || row >= LETTER_PANEL_ROWS) return -1;
+    int bucket = row * LETTER_PANEL_COLS + col;
+    return bucket < Catalog::LETTER_BUCKETS ? bucket : -1;
+  }
+
+  void openLetterPanel() {
+    Serial.println("Letter panel opened");
+    mode = HomeScreenMode::LETTERS;
+    gridDirty = true;
+  }
+
+  void closeLetterPanel() {
+    mode = HomeScreenMode::GRID;
+    gridDirty = true;
+  }
+
+  // Spring naar de pagina met het eerste item van deze letter
+  void handleLetterClick(int x, int y) {
+    int bucket = getLetterBucketAtPosition(x, y);
+    if (bucket < 0) return;
+
+    const Catalog& catalog = ItemRepository::getInstance().getCatalog();
+    if (catalog.letterCount(bucket) == 0) {
+      Serial.printf("Letter %d has no items\n", bucket);
+      return;
+    }
+    scrollOffset = (catalog.letterOffset(bucket) / ITEMS_PER_PAGE) * ITEMS_PER_PAGE;
+    onFrequentPage = false;
+    Serial.printf("Jump to letter %c: offset=%d\n", bucket < 26 ? 'A' + bucket : '#', scrollOffset);
+    closeLetterPanel();
+  }
+
+  void openSearch() {
+    Serial.println("Search opened");
+    mode = HomeScreenMode::SEARCH;
+    searchQuery[0] = '\0';
+    searchLength = 0;
+    searchOffset = 0;
+    search.clear();
+    needsRedraw = true;
+  }
+
+  void closeSearch() {
+    mode = HomeScreenMode::GRID;
+    needsRedraw = true;
+  }
+
+  void runSearch() {
+    uint32_t start = micros();
+    size_t found = search.run(ItemRepository::getInstance().getCatalog(), searchQuery);
+    Serial.printf("Search '%s': %u %sresults in %lu us\n", searchQuery, (unsigned)found,
+                  search.isFuzzy() ? "fuzzy " : "", (unsigned long)(micros() - start));
+    searchOffset = 0;
+    gridDirty = true;
+  }
+
+  void handleKey(char key) {
+    if (key == '\b') {
+      if (searchLength == 0) return;
+      searchQuery[--searchLength] = '\0';
+    } else {
+      if (searchLength >= SEARCH_QUERY_MAX) return;
+      if (key == ' ' && (searchLength == 0 || searchQuery[searchLength - 1] == ' ')) return;
+      searchQuery[searchLength++] = key;
+      searchQuery[searchLength] = '\0';
+    }
+    runSearch();
+  }
+
+  // Moet matchen met DisplayManager::drawSearchHeader / drawKeyboard
+  void handleSearchClick(int x, int y) {
+    if (y < HEADER_HEIGHT) {
+      if (x >= PORTRAIT_WIDTH - SEARCH_CLOSE_WIDTH) closeSearch();
+      return;
+    }
+
+    if (y < KEYBOARD_Y) {
+      int col = x / (PORTRAIT_WIDTH / SEARCH_RESULT_COLS);
+      int row = (y - HEADER_HEIGHT) / SEARCH_CELL_HEIGHT;
+      if (col >= SEARCH_RESULT_COLS) col = SEARCH_RESULT_COLS - 1;
+      size_t result = searchOffset + row * SEARCH_RESULT_COLS + col;
+      pickedFromFrequent = false;
+      if (result < search.size()) selectItem(search.slotAt(result));
+      return;
+    }
+
+    int col = x / (PORTRAIT_WIDTH / KEYBOARD_COLS);
+    int row = (y - KEYBOARD_Y) / KEY_HEIGHT;
+    if (col >= KEYBOARD_COLS) col = KEYBOARD_COLS - 1;
+    if (row >= KEYBOARD_ROWS) row = KEYBOARD_ROWS - 1;
+    size_t key = row * KEYBOARD_COLS + col;
+    if (key < strlen(KEYBOARD_LAYOUT)) handleKey(KEYBOARD_LAYOUT[key]);
+  }
+
+  void scrollSearch(int direction) {
+    size_t next = searchOffset + direction * SEARCH_RESULT_CELLS;
+    if (direction < 0 && searchOffset < SEARCH_RESULT_CELLS) return;
+    if (direction > 0 && next >= search.size()) return;
+    searchOffset = next;
+    gridDirty = true;
+  }
+
+  // Header en alleen de treffer cellen die veranderd zijn
+  void renderSearch(bool full) {
+    if (full) {
+      display->clear();
+      display->drawKeyboard();
+      for (int i = 0; i < SEARCH_RESULT_CELLS; i++) shownSlots[i] = -2;  // Alles tekenen
+    }
+    display->drawSearchHeader(searchQuery, searchOffset, search.size(), search.isFuzzy());
+
+    ItemRepository& repo = ItemRepository::getInstance();
+    for (int i = 0; i < SEARCH_RESULT_CELLS; i++) {
+      size_t result = searchOffset + i;
+      int slot = result < search.size() ? search.slotAt(result) : -1;
+      if (slot == shownSlots[i]) continue;
+      shownSlots[i] = slot;
+      if (slot < 0) {
+        display->drawSearchResultCell(i, nullptr, "");
+      } else {
+        const Item& item = items()[slot];
+        display->drawSearchResultCell(i, &item, repo.nameOf(item));
+      }
+    }
+  }
+
   int getTotalPages() {
-    return (allItems.size() + ITEMS_PER_PAGE - 1) / ITEMS_PER_PAGE;
+    return (items().size() + ITEMS_PER_PAGE - 1) / ITEMS_PER_PAGE + (hasFrequentPage() ? 1 : 0);
+  }
+
+  const char* pageTitle() const {
+    return onFrequentPage ? "Vaak gekozen" : "Afval Sorteren";
+  }
+
+  void drawGridContent() {
+    const Catalog& catalog = ItemRepository::getInstance().getCatalog();
+    if (mode == HomeScreenMode::LETTERS) {
+      display->drawLetterPanel(catalog, getCurrentLetterBucket());
+    } else if (onFrequentPage) {
+      display->drawItemGrid(catalog, frequentItems());
+    } else {
+      display->drawItemGrid(catalog, items(), scrollOffset);
+    }
   }
 
   int getCurrentPage() {
-    return (scrollOffset / ITEMS_PER_PAGE) + 1;
+    if (onFrequentPage) return 1;
+    return (scrollOffset / ITEMS_PER_PAGE) + 1 + (hasFrequentPage() ? 1 : 0);
   }
 
 public:
   HomeScreen(DisplayManager* d) : display(d) {
-    loadAllItems();
+    syncCatalog();
   }
 
   ScreenType getType() const override { return ScreenType::HOME; }
 
+  // Scroll positie blijft behouden tussen sleep/wake
   void onEnter() override {
     Serial.println("HomeScreen: Entering");
+    syncCatalog();
     display->getTFT()->setRotation(0);
     mode = HomeScreenMode::GRID;
+    selectedItemIndex = -1;
+    pendingItemIndex = -1;
     needsRedraw = true;
+    startSession();
   }
 
   void onExit() override {
@@ -177,6 +415,15 @@ public:
   }
 
   void handleEvent(const Event& event) override {
+    // Catalogus kan sinds de laatste update gewisseld zijn (kleiner): eerst
+    // syncen, anders wijzen slots naar items die er niet meer zijn
+    syncCatalog();
+    // Tik op het resultaat sluit een keuze af; alles daarvoor telt mee
+    if (mode != HomeScreenMode::RESULT &&
+        (event.type == EventType::TOUCH_PRESSED || event.type == EventType::SWIPE_LEFT ||
+         event.type == EventType::SWIPE_RIGHT)) {
+      sessionTaps++;
+    }
     if (event.type == EventType::TOUCH_PRESSED) {
       handleTouchEvent(event);
     } else if (event.type == EventType::SWIPE_LEFT) {
@@ -184,12 +431,16 @@ public:
       if (mode == HomeScreenMode::GRID) {
         Serial.println("Swipe left -> next page");
         scrollDown();
+      } else if (mode == HomeScreenMode::SEARCH) {
+        scrollSearch(1);
       }
     } else if (event.type == EventType::SWIPE_RIGHT) {
       // Swipe rechts = vorige pagina
       if (mode == HomeScreenMode::GRID) {
         Serial.println("Swipe right -> prev page");
         scrollUp();
+      } else if (mode == HomeScreenMode::SEARCH) {
+        scrollSearch(-1);
       }
     }
   }
@@ -208,6 +459,19 @@ public:
       case HomeScreenMode::DIRTY_POPUP:
         handlePopupClick(x, y);
         break;
+
+      case HomeScreenMode::SEARCH:
+        handleSearchClick(x, y);
+        break;
+
+      case HomeScreenMode::LETTERS:
+        // Header of footer = sluiten zonder te springen
+        if (y < HEADER_HEIGHT || y >= PORTRAIT_HEIGHT - FOOTER_HEIGHT) {
+          closeLetterPanel();
+          return;
+        }
+        handleLetterClick(x, y);
+        break;
         
       case HomeScreenMode::GRID:
         // Footer area (y >= 270 = 320-50)
@@ -224,11 +488,15 @@ public:
             scrollDown();
             return;
           }
-          // Midden van footer - doe niets
+          // Midden van footer - A-Z paneel
+          if (x >= FOOTER_INDEX_X_MIN && x <= FOOTER_INDEX_X_MAX && getTotalPages() > 1) {
+            openLetterPanel();
+          }
           return;
         }
-        // Header tapped - doe niets (of scroll omhoog als je wilt)
+        // Header tapped - zoeken
         if (y < 40) {
+          openSearch();
           return;
         }
         // Grid area (y between 40 and 269)
@@ -238,60 +506,98 @@ public:
     }
   }
 
-  void update() override {}
+  void update() override {
+    syncCatalog();
+  }
+
+  bool needsRender() const override { return needsRedraw || gridDirty; }
+
+  // syncCatalog zet popup en zoeken terug naar de grid: wacht tot de
+  // gebruiker daar zelf is (of het scherm in slaap valt)
+  bool canSwapCatalog() const override { return mode == HomeScreenMode::GRID; }
 
   void render() override {
+    if (mode == HomeScreenMode::SEARCH && (needsRedraw || gridDirty)) {
+      renderSearch(needsRedraw);
+      needsRedraw = false;
+      gridDirty = false;
+      return;
+    }
+    if (!needsRedraw && gridDirty) {
+      // Footer blijft staan; alleen paginanummer en content opnieuw
+      gridDirty = false;
+      display->drawHeader(pageTitle(), getCurrentPage(), getTotalPages());
+      drawGridContent();
+      return;
+    }
     if (!needsRedraw) return;
     needsRedraw = false;
+    gridDirty = false;
     
     switch (mode) {
       case HomeScreenMode::GRID:
+      case HomeScreenMode::LETTERS:
         display->clear();
-        display->drawHeader("Afval Sorteren", getCurrentPage(), getTotalPages());
-        display->drawItemGrid(allItems, scrollOffset);
+        display->drawHeader(pageTitle(), getCurrentPage(), getTotalPages());
+        drawGridContent();
         display->drawFooter("Volgende >", getCurrentPage(), getTotalPages());
         break;
         
       case HomeScreenMode::DIRTY_POPUP:
         if (pendingItemIndex >= 0) {
-          display->drawDirtyCleanPopup(allItems[pendingItemIndex]);
+          const Item& item = items()[pendingItemIndex];
+          display->drawDirtyCleanPopup(item, nameOf(item));
         }
         break;
         
       case HomeScreenMode::RESULT:
         if (selectedItemIndex >= 0) {
-          display->drawResultScreen(allItems[selectedItemIndex], 
-                                    allItems[selectedItemIndex].isDirty);
+          const Item& item = items()[selectedItemIndex];
+          display->drawResultScreen(item, nameOf(item),
+                                    ItemRepository::getInstance().descriptionOf(item),
+                                    selectedDirty);
         }
         break;
+
+      case HomeScreenMode::SEARCH:
+        break;  // Zie renderSearch
     }
     Serial.printf("Rendered (mode=%d, page=%d/%d)\n", (int)mode, getCurrentPage(), getTotalPages());
   }
 
+  // Volgorde: [Vaak gekozen] -> A-Z pagina's -> terug naar het begin
   void scrollUp() {
-    if (scrollOffset >= ITEMS_PER_PAGE) {
+    if (onFrequentPage) {
+      onFrequentPage = false;
+      scrollOffset = ((items().size() - 1) / ITEMS_PER_PAGE) * ITEMS_PER_PAGE;
+    } else if (scrollOffset >= ITEMS_PER_PAGE) {
       scrollOffset -= ITEMS_PER_PAGE;
+    } else if (hasFrequentPage()) {
+      onFrequentPage = true;
     } else {
       // Wrap around naar laatste pagina
-      int lastPageOffset = ((allItems.size() - 1) / ITEMS_PER_PAGE) * ITEMS_PER_PAGE;
+      int lastPageOffset = ((items().size() - 1) / ITEMS_PER_PAGE) * ITEMS_PER_PAGE;
       scrollOffset = lastPageOffset;
     }
-    needsRedraw = true;
-    Serial.printf("Page up: offset=%d\n", scrollOffset);
+    gridDirty = true;
+    Serial.printf("Page up: offset=%d%s\n", scrollOffset, onFrequentPage ? " (frequent)" : "");
   }
 
   void scrollDown() {
-    if (scrollOffset + ITEMS_PER_PAGE < allItems.size()) {
+    if (onFrequentPage) {
+      onFrequentPage = false;
+      scrollOffset = 0;
+    } else if (scrollOffset + ITEMS_PER_PAGE < items().size()) {
       scrollOffset += ITEMS_PER_PAGE;
     } else {
       // Wrap around naar eerste pagina
       scrollOffset = 0;
+      onFrequentPage = hasFrequentPage();
     }
-    needsRedraw = true;
-    Serial.printf("Page down: offset=%d\n", scrollOffset);
+    gridDirty = true;
+    Serial.printf("Page down: offset=%d%s\n", scrollOffset, onFrequentPage ? " (frequent)" : "");
   }
 
-  const std::vector<Item>& getAllItems() const { return allItems; }
   void clearSelection() { selectedItemIndex = -1; needsRedraw = true; }
 };
 
@@ -22,6 +22,13 @@ public:
   virtual void handleEvent(const Event& event) = 0;
   virtual void update() = 0;
   virtual void render() = 0;
+
+  // True als render() iets te tekenen heeft (scheduler triggert dan render)
+  virtual bool needsRender() const { return true; }
+
+  // False zolang het scherm midden in een interactie zit die een catalogus
+  // wissel zou onderbreken (bijv. popup of zoeken); de wissel wacht dan
+  virtual bool canSwapCatalog() const { return true; }
 };
 
 #endif
\ No newline at end of file
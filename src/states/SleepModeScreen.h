@@ -6,33 +6,43 @@
 #include "../services/LEDAnimationService.h"
 #include "../models/Item.h"
 #include "../models/ItemRepository.h"
-#include <vector>
 
 class SleepModeScreen : public ScreenState {
 private:
   DisplayManager* display;
   LEDAnimationService* ledAnimation;
-  std::vector<Item> allItems;
   int currentItemIndex = 0;
   unsigned long lastItemChangeTime = 0;
   const unsigned long ITEM_DISPLAY_TIME = 5000;  // 5 seconds
   bool needsRedraw = true;
+  uint32_t loadedVersion = 0;
 
   // Large circle in center
   const int CIRCLE_RADIUS = 70;
   const int CIRCLE_BORDER_THICKNESS = 8;
 
-  void loadItems() {
+  // Zero-copy view; altijd vers opvragen zodat een catalogus swap veilig is
+  ItemSpan items() const {
+    return ItemRepository::getInstance().getAllItems();
+  }
+
+  void syncCatalog() {
     ItemRepository& repo = ItemRepository::getInstance();
-    allItems = repo.getAllItems();
-    Serial.printf("SleepModeScreen: Loaded %d items\n", allItems.size());
+    if (loadedVersion == repo.getVersion()) return;
+    loadedVersion = repo.getVersion();
+
+    if (currentItemIndex >= (int)items().size()) {
+      currentItemIndex = 0;
+    }
+    needsRedraw = true;
+    Serial.printf("SleepModeScreen: catalog v%u, %d items\n", loadedVersion, items().size());
   }
 
   void drawCurrentItem() {
-    if (allItems.empty()) return;
+    if (items().empty()) return;
 
     TFT_eSPI* tft = display->getTFT();
-    const Item& item = allItems[currentItemIndex];
+    const Item& item = items()[currentItemIndex];
 
     // Clear screen to black
     tft->fillScreen(TFT_BLACK);
@@ -51,7 +61,7 @@ private:
     tft->setTextDatum(MC_DATUM);
     
     // Handle long names - wrap text inside circle
-    String name = item.name;
+    String name = ItemRepository::getInstance().nameOf(item);
     int maxWidth = CIRCLE_RADIUS * 2 - 20;  // Max width inside circle
     
     if (name.length() <= 8) {
@@ -101,13 +111,13 @@ private:
     
     tft->setTextDatum(TL_DATUM);
 
-    Serial.printf("Drew item: %s (index %d)\n", item.name.c_str(), currentItemIndex);
+    Serial.printf("Drew item: %s (index %d)\n", name.c_str(), currentItemIndex);
   }
 
   void updateLEDsForCurrentItem() {
-    if (allItems.empty()) return;
+    if (items().empty()) return;
 
-    const Item& item = allItems[currentItemIndex];
+    const Item& item = items()[currentItemIndex];
 
     // Extract RGB from 16-bit color (RGB565)
     uint8_t r = (item.color >> 11) << 3;           // 5 bits -> 8 bits
@@ -137,8 +147,8 @@ public:
   void onEnter() override {
     Serial.println("SleepModeScreen: Entering sleep mode");
     
-    loadItems();
-    currentItemIndex = 0;
+    // Rotatie gaat verder waar hij bij de vorige sleep stopte
+    syncCatalog();
     lastItemChangeTime = millis();
     needsRedraw = true;
 
@@ -163,26 +173,28 @@ public:
   }
 
   void update() override {
-    ledAnimation->update();
+    syncCatalog();
 
     // Check if it's time to switch to next item
     if (millis() - lastItemChangeTime >= ITEM_DISPLAY_TIME) {
       lastItemChangeTime = millis();
       
       // Move to next item (cycle back to 0 if at end)
-      if (!allItems.empty()) {
-        currentItemIndex = (currentItemIndex + 1) % allItems.size();
+      if (!items().empty()) {
+        currentItemIndex = (currentItemIndex + 1) % items().size();
         needsRedraw = true;
         updateLEDsForCurrentItem();
       }
     }
   }
 
+  bool needsRender() const override { return needsRedraw; }
+
   void render() override {
     if (!needsRedraw) return;
     needsRedraw = false;
 
-    if (allItems.empty()) {
+    if (items().empty()) {
       Serial.println("SleepModeScreen: No items to render!");
       TFT_eSPI* tft = display->getTFT();
       tft->fillScreen(TFT_BLACK);
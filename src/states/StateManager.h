@@ -2,20 +2,56 @@
 #define STATE_MANAGER_H
 
 #include <memory>
+#include <esp_heap_caps.h>
 #include "ScreenState.h"
 #include "HomeScreen.h"
 #include "SleepModeScreen.h"
 #include "../display/DisplayManager.h"
 #include "../services/LEDAnimationService.h"
 
+// Schermen leven zo lang als de applicatie; overgangen gaan alleen via
+// onExit()/onEnter(), zodat scroll positie en caches behouden blijven.
 class StateManager {
 private:
-  std::unique_ptr<ScreenState> currentState;
   std::unique_ptr<HomeScreen> homeState;
   std::unique_ptr<SleepModeScreen> sleepState;
+  ScreenState* currentState = nullptr;
   DisplayManager* display;
   LEDAnimationService* ledAnimation;
 
+  // Netto vastgehouden heap blokken per overgang (allocated_blocks na -
+  // voor). Geen aantal allocaties: een malloc + free binnen de overgang
+  // valt weg, en allocaties van de netwerk taak op core 0 tellen mee.
+  uint32_t transitions = 0;
+  int32_t lastBlockDelta = 0;
+  int32_t maxBlockDelta = 0;
+  int32_t totalBlockDelta = 0;
+
+  static size_t allocatedBlocks() {
+    multi_heap_info_t info;
+    heap_caps_get_info(&info, MALLOC_CAP_8BIT);
+    return info.allocated_blocks;
+  }
+
+  void switchTo(ScreenState* next) {
+    size_t blocksBefore = allocatedBlocks();
+
+    if (currentState) {
+      currentState->onExit();
+    }
+    currentState = next;
+    currentState->onEnter();
+
+    int32_t delta = (int32_t)allocatedBlocks() - (int32_t)blocksBefore;
+    transitions++;
+    lastBlockDelta = delta;
+    totalBlockDelta += delta;
+    if (delta > maxBlockDelta) maxBlockDelta = delta;
+    if (delta != 0) {
+      Serial.printf("Screen transition: %+d net retained heap blocks\n", (int)delta);
+    }
+  }
+
 public:
   StateManager(DisplayManager* d, LEDAnimationService* led) 
     : display(d), ledAnimation(led) {
@@ -24,28 +60,16 @@ public:
     sleepState = std::make_unique<SleepModeScreen>(d, led);
     
     // START WITH SLEEPMODE (shows 6 items with circles)
-    currentState = std::move(sleepState);
+    currentState = sleepState.get();
     currentState->onEnter();
   }
 
   void goToSleepMode() {
-    if (currentState) {
-      currentState->onExit();
-    }
-    
-    sleepState = std::make_unique<SleepModeScreen>(display, ledAnimation);
-    currentState = std::move(sleepState);
-    currentState->onEnter();
+    switchTo(sleepState.get());
   }
 
   void goToHomeScreen() {
-    if (currentState) {
-      currentState->onExit();
-    }
-    
-    homeState = std::make_unique<HomeScreen>(display);
-    currentState = std::move(homeState);
-    currentState->onEnter();
+    switchTo(homeState.get());
   }
 
   void handleEvent(const Event& event) {
@@ -66,12 +90,25 @@ public:
     }
   }
 
+  bool needsRender() const {
+    return currentState && currentState->needsRender();
+  }
+
+  bool canSwapCatalog() const {
+    return !currentState || currentState->canSwapCatalog();
+  }
+
   ScreenType getCurrentScreenType() const {
     if (currentState) {
       return currentState->getType();
     }
     return ScreenType::HOME;
   }
+
+  void printTransitionStats(Print& out) const {
+    out.printf("screen transitions=%u, net retained heap blocks per transition: last=%+d max=%+d total=%+d\n",
+               transitions, (int)lastBlockDelta, (int)maxBlockDelta, (int)totalBlockDelta);
+  }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,120 @@
+// Host benchmark: catalogus lookups met en zonder indexen.
+//
+// Catalog.h is Arduino-vrij, dus dit draait op de PC:
+//   g++ -O2 -std=gnu++14 -Isrc tools/bench/catalog_index_bench.cpp -o /tmp/catalog_bench
+//   /tmp/catalog_bench
+//
+// "scan" is de oude aanpak (lineair zoeken / filteren met kopie),
+// "index" gebruikt de tabellen die Catalog::finalize() bouwt.
+#include "models/Catalog.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+using Clock = std::chrono::steady_clock;
+
+static volatile uintptr_t sink;  // Voorkomt dat de compiler het werk weggooit
+
+template <typename F>
+static double nsPerOp(int ops, F f) {
+  auto start = Clock::now();
+  for (int i = 0; i < ops; i++) f(i);
+  auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+  return (double)elapsed.count() / ops;
+}
+
+static void buildCatalog(Catalog& catalog, int n, std::mt19937& rng, std::vector<int>& ids) {
+  static const char* descriptions[] = {"Leeg en gespoeld", "Onbeschadigd papier", "Biologisch afval", ""};
+  ids.clear();
+  for (int i = 0; i < n; i++) ids.push_back(1 + i * 3);  // Ids met gaten, zoals uit de database
+  std::shuffle(ids.begin(), ids.end(), rng);
+
+  catalog.clear();
+  catalog.reserve(n);
+  char name[32];
+  for (int i = 0; i < n; i++) {
+    snprintf(name, sizeof(name), "%c%c item %05d", 'A' + (int)(rng() % 26), 'a' + (int)(rng() % 26), i);
+    catalog.add(ids[i], name, descriptions[i % 4], (ItemCategory)(rng() % ITEM_CATEGORY_COUNT), 0, false);
+  }
+  catalog.finalize();
+}
+
+int main() {
+  std::mt19937 rng(42);
+  const int sizes[] = {100, 1000, 10000};
+
+  printf("%6s | %-22s | %10s | %10s\n", "items", "operatie", "scan ns", "index ns");
+  for (int n : sizes) {
+    Catalog catalog;
+    std::vector<int> ids;
+    buildCatalog(catalog, n, rng, ids);
+    ItemSpan all = catalog.all();
+    const int ops = 200000 / n + 200;
+
+    double scanId = nsPerOp(ops * 10, [&](int i) {
+      int id = ids[i % n];
+      for (const auto& item : all) {
+        if (item.id == id) { sink = (uintptr_t)&item; break; }
+      }
+    });
+    double indexId = nsPerOp(ops * 10, [&](int i) { sink = (uintptr_t)catalog.findById(ids[i % n]); });
+    printf("%6d | %-22s | %10.1f | %10.1f\n", n, "getItemById", scanId, indexId);
+
+    double scanLetters = nsPerOp(ops, [&](int) {
+      std::vector<char> letters;
+      for (const auto& item : all) {
+        char letter = toupper((unsigned char)catalog.nameOf(item)[0]);
+        bool found = false;
+        for (char l : letters) {
+          if (l == letter) { found = true; break; }
+        }
+        if (!found) letters.push_back(letter);
+      }
+      std::sort(letters.begin(), letters.end());
+      sink = letters.size();
+    });
+    double indexLetters = nsPerOp(ops, [&](int) {
+      std::vector<char> letters;
+      for (uint8_t b = 0; b < 26; b++) {
+        if (catalog.letterCount(b) > 0) letters.push_back('A' + b);
+      }
+      sink = letters.size();
+    });
+    printf("%6d | %-22s | %10.1f | %10.1f\n", n, "getAvailableLetters", scanLetters, indexLetters);
+
+    double scanLetter = nsPerOp(ops, [&](int i) {
+      char letter = 'A' + i % 26;
+      std::vector<Item> result;
+      for (const auto& item : all) {
+        if (toupper((unsigned char)catalog.nameOf(item)[0]) == letter) result.push_back(item);
+      }
+      sink = result.size();
+    });
+    double indexLetter = nsPerOp(ops, [&](int i) {
+      size_t count = 0;
+      for (const auto& item : catalog.byLetter('A' + i % 26)) count += item.id != 0;
+      sink = count;
+    });
+    printf("%6d | %-22s | %10.1f | %10.1f\n", n, "getItemsByLetter", scanLetter, indexLetter);
+
+    double scanCategory = nsPerOp(ops, [&](int i) {
+      ItemCategory category = (ItemCategory)(i % ITEM_CATEGORY_COUNT);
+      std::vector<Item> result;
+      for (const auto& item : all) {
+        if (item.category == category) result.push_back(item);
+      }
+      sink = result.size();
+    });
+    double indexCategory = nsPerOp(ops, [&](int i) {
+      size_t count = 0;
+      for (const auto& item : catalog.byCategory((ItemCategory)(i % ITEM_CATEGORY_COUNT))) {
+        count += item.id != 0;
+      }
+      sink = count;
+    });
+    printf("%6d | %-22s | %10.1f | %10.1f\n", n, "getItemsByCategory", scanCategory, indexCategory);
+
+    printf("%6d | %-22s | %10s | %10u bytes\n", n, "index geheugen", "-", (unsigned)catalog.indexBytes());
+  }
+  return 0;
+}
@@ -0,0 +1,111 @@
+"""Drain doorvoer van een offline queue tegen een lokale API instantie.
+
+Verstuurt N selecties zoals de ESP ze na een storing inhaalt:
+  - single-new: één POST /sentData per selectie, nieuwe verbinding per post
+                (oude firmware: HTTPClient per request)
+  - single:     één POST /sentData per selectie over één keep-alive verbinding
+  - batch B:    POST /sentBatch/{locatie} met B selecties per request
+                (DatabaseService::processPendingPosts, PENDING_BATCH_SIZE)
+
+    uvicorn api:app --port 8080 --timeout-keep-alive 330   (in database/api)
+    python tools/bench/drain_bench.py --count 500 --batch 8 32 128
+
+Let op: dit telt echt selecties op in selected_at_location (of in de
+pending queue als de database offline is) voor --location; gebruik een
+test database of een eigen locatie naam.
+"""
+import argparse
+import http.client
+import json
+import random
+import socket
+import time
+from urllib.parse import quote, urlsplit
+
+ITEMS = ["Fles", "Doos (Karton)", "Blikje", "Krant", "Plastic zak", "Bananenschil",
+         "Melkpak", "Pizzadoos", "Koffiebeker", "Glazen pot"]
+
+
+def selections(count, seed=1):
+    rng = random.Random(seed)
+    return [(rng.choice(ITEMS), rng.random() < 0.1) for _ in range(count)]
+
+
+class Api:
+    def __init__(self, url, keep_alive):
+        parts = urlsplit(url)
+        self.host = parts.hostname
+        self.port = parts.port or 80
+        self.keep_alive = keep_alive
+        self.conn = None
+        self.requests = 0
+
+    def post(self, path, body=None):
+        if self.conn is None:
+            self.conn = http.client.HTTPConnection(self.host, self.port, timeout=30)
+            self.conn.connect()
+            # Zoals de ESP (setNoDelay): anders meet je vooral Nagle + delayed ACK
+            self.conn.sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        headers = {"Content-Type": "application/json"} if body is not None else {}
+        data = json.dumps(body, separators=(",", ":")).encode() if body is not None else b""
+        self.conn.request("POST", path, body=data, headers=headers)
+        response = self.conn.getresponse()
+        payload = response.read()
+        self.requests += 1
+        if not self.keep_alive:
+            self.conn.close()
+            self.conn = None
+        if response.status != 200:
+            raise RuntimeError("%s -> %d %s" % (path, response.status, payload[:200]))
+        return json.loads(payload)
+
+
+def drain_single(api, location, queue):
+    for item, dirty in queue:
+        api.post("/sentData/%s/%s/%s" % (quote(location, safe=""), quote(item, safe=""),
+                                         "true" if dirty else "false"))
+
+
+def drain_batch(api, location, queue, size):
+    for i in range(0, len(queue), size):
+        batch = [[item, 1 if dirty else 0] for item, dirty in queue[i:i + size]]
+        api.post("/sentBatch/%s" % quote(location, safe=""), batch)
+
+
+def run(label, api, drain):
+    start = time.perf_counter()
+    drain()
+    seconds = time.perf_counter() - start
+    return label, api.requests, seconds
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--url", default="http://localhost:8080")
+    parser.add_argument("--location", default="bench")
+    parser.add_argument("--count", type=int, default=500, help="selecties in de queue")
+    parser.add_argument("--batch", type=int, nargs="+", default=[8, 32, 128])
+    parser.add_argument("--skip-single", action="store_true",
+                        help="alleen batches (losse posts duren lang bij een grote queue)")
+    args = parser.parse_args()
+
+    queue = selections(args.count)
+    rows = []
+    if not args.skip_single:
+        for label, keep_alive in (("single-new", False), ("single", True)):
+            api = Api(args.url, keep_alive)
+            rows.append(run(label, api, lambda: drain_single(api, args.location, queue)))
+    for size in args.batch:
+        api = Api(args.url, True)
+        rows.append(run("batch %d" % size, api,
+                        lambda: drain_batch(api, args.location, queue, size)))
+
+    print("%d selections, location %r, %s" % (args.count, args.location, args.url))
+    print("%-11s | %8s | %8s | %10s | %8s" % ("mode", "requests", "seconds", "sel/s", "ms/req"))
+    for label, requests, seconds in rows:
+        print("%-11s | %8d | %8.2f | %10.1f | %8.1f" % (
+            label, requests, seconds, args.count / seconds, 1000 * seconds / requests))
+
+
+if __name__ == "__main__":
+    main()
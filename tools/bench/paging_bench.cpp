@@ -0,0 +1,126 @@
+// Host benchmark: een catalogus van 5000 items in place (zoals uit de
+// flash partitie) doorlopen met de toegangspatronen van de schermen, met
+// een blok cache model (FlashBlockModel) van verschillende groottes.
+// Meldt page-ins, hit rate, het slechtste aantal page-ins per stap en de
+// slechtste bladertijd: CPU tijd op de host plus page-ins maal
+// FlashBlockModel::blockLoadUs() (QIO 40 MHz).
+//
+//   g++ -O2 -std=gnu++14 -Isrc tools/bench/paging_bench.cpp -o /tmp/paging_bench
+//   /tmp/paging_bench [items]
+//
+// Tijden op de host zeggen weinig over flash; op het apparaat meet het
+// console commando 'catpage' dezelfde patronen met echte cache misses.
+#include "models/Catalog.h"
+#include "diagnostics/FlashBlockModel.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+static const size_t PAGE_ITEMS = 4;  // GRID_ITEM_COLS * GRID_ITEM_ROWS
+
+using Clock = std::chrono::steady_clock;
+
+static void fill(Catalog& catalog, int n) {
+  static const char* words[] = {"fles", "doos", "zak", "blik", "pot", "folie", "beker", "krant",
+                                "schil", "resten", "dop", "bak", "tube", "karton", "glas", "verpakking"};
+  std::mt19937 rng(11);
+  catalog.reserve(n);
+  char name[48];
+  char description[24];
+  for (int i = 0; i < n; i++) {
+    snprintf(name, sizeof(name), "%c%s %s %05d", 'A' + (int)(rng() % 26), words[rng() % 16],
+             words[rng() % 16], i);
+    snprintf(description, sizeof(description), i % 4 ? "Test item %d" : "", i);
+    catalog.add(1 + i * 3, name, description, (ItemCategory)(rng() % ITEM_CATEGORY_COUNT), 0x6B4D, i % 3 == 0);
+  }
+}
+
+struct Walk {
+  uint32_t steps = 0;
+  uint32_t maxPageIns = 0;
+  double maxUs = 0;
+  double worstUs = 0;   // Eén stap: tijd + page-ins * blok laadtijd
+};
+
+static volatile uint32_t sink;
+
+static void readItems(const Catalog& catalog, size_t first, size_t count, FlashBlockModel& model) {
+  for (size_t slot = first; slot < first + count && slot < (size_t)catalog.size(); slot++) {
+    const Item& item = catalog[slot];
+    const char* name = catalog.nameOf(item);
+    size_t length = strlen(name);
+    model.touch(&item, sizeof(Item));
+    model.touch(name, length + 1);
+    sink += length + item.color;
+  }
+}
+
+template <typename F>
+static void step(Walk& walk, FlashBlockModel& model, F work) {
+  uint32_t before = model.pageInCount();
+  auto start = Clock::now();
+  work();
+  double us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+  uint32_t pageIns = model.pageInCount() - before;
+  double worst = us + pageIns * (double)model.blockLoadUs();
+  walk.steps++;
+  if (us > walk.maxUs) walk.maxUs = us;
+  if (pageIns > walk.maxPageIns) walk.maxPageIns = pageIns;
+  if (worst > walk.worstUs) walk.worstUs = worst;
+}
+
+static void printRow(const char* label, size_t blocks, const Walk& walk, const FlashBlockModel& model) {
+  printf("%-9s | %6u | %5u | %8u | %8u | %6.1f%% | %7.2f | %8.0f\n", label, (unsigned)blocks,
+         (unsigned)walk.steps, (unsigned)model.pageInCount(), (unsigned)walk.maxPageIns,
+         model.hitRate(), walk.maxUs, walk.worstUs);
+}
+
+int main(int argc, char** argv) {
+  int n = argc > 1 ? atoi(argv[1]) : 5000;
+
+  Catalog source;
+  fill(source, n);
+  source.finalize();
+  std::vector<uint8_t> snapshot;
+  source.serialize(snapshot);
+
+  Catalog catalog;
+  if (!catalog.attach(snapshot.data(), snapshot.size())) abort();
+  printf("%d items, snapshot %u bytes, heap %u bytes (%s)\n\n", n, (unsigned)snapshot.size(),
+         (unsigned)catalog.heapBytes(), catalog.storageName());
+  printf("%-9s | %6s | %5s | %8s | %8s | %7s | %7s | %8s\n",
+         "pattern", "blocks", "steps", "page-ins", "max/step", "hit", "max us", "worst us");
+
+  const size_t cacheSizes[] = {4, 8, 16};
+  for (size_t blocks : cacheSizes) {
+    FlashBlockModel model(blocks);
+
+    Walk grid;
+    for (size_t first = 0; first < (size_t)n; first += PAGE_ITEMS) {
+      step(grid, model, [&]() { readItems(catalog, first, PAGE_ITEMS, model); });
+    }
+    printRow("grid", blocks, grid, model);
+
+    model.reset();
+    Walk letters;
+    for (char letter = 'A'; letter <= 'Z'; letter++) {
+      ItemSpan span = catalog.byLetter(letter);
+      if (span.empty()) continue;
+      size_t first = span.begin() - catalog.all().begin();
+      step(letters, model, [&]() { readItems(catalog, first, PAGE_ITEMS, model); });
+    }
+    printRow("letters", blocks, letters, model);
+
+    // Willekeurige sprongen (zoek treffers): slechtste geval voor de cache
+    model.reset();
+    Walk random;
+    std::mt19937 rng(5);
+    for (int i = 0; i < 1000; i++) {
+      size_t slot = rng() % n;
+      step(random, model, [&]() { readItems(catalog, slot, 1, model); });
+    }
+    printRow("random", blocks, random, model);
+  }
+  return 0;
+}
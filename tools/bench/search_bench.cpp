@@ -0,0 +1,122 @@
+// Host benchmark: zoeken per toetsaanslag (prefix index) en tikfout-
+// tolerant zoeken (trigram index) op grote synthetische catalogi.
+//
+//   g++ -O2 -std=gnu++14 -Isrc tools/bench/search_bench.cpp -o /tmp/search_bench
+//   /tmp/search_bench
+//
+// Typt een paar zoekwoorden letter voor letter, zoals op het toetsenbord,
+// en meet de tijd per aanslag. De ESP32 is grofweg 10-20x trager dan een
+// desktop core; houd dat in gedachten bij de getallen.
+#include "models/ItemSearch.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+
+using Clock = std::chrono::steady_clock;
+
+static const char* WORDS[] = {
+  "plastic", "fles", "doos", "karton", "papier", "blik", "glas", "pot", "zak",
+  "koffiebeker", "Crème", "fraîche", "bakje", "schil", "appel", "banaan", "krant",
+  "tijdschrift", "wattenstaafje", "luier", "chips", "verpakking", "folie", "dop",
+  "melkpak", "yoghurt", "beker", "tandenborstel", "pizzadoos", "theezakje",
+  "bananenschil", "aluminium", "eierdoos", "batterij", "spuitbus", "kaarsvet",
+};
+static const int WORD_COUNT = sizeof(WORDS) / sizeof(WORDS[0]);
+
+static void buildCatalog(Catalog& catalog, int n, std::mt19937& rng) {
+  catalog.clear();
+  catalog.reserve(n);
+  for (int i = 0; i < n; i++) {
+    std::string name = WORDS[rng() % WORD_COUNT];
+    int extra = rng() % 3;
+    for (int w = 0; w < extra; w++) {
+      name += (w == 0 && rng() % 2) ? " (" : " ";
+      name += WORDS[rng() % WORD_COUNT];
+    }
+    if (name.find('(') != std::string::npos) name += ")";
+    name += " " + std::to_string(i);  // Unieke namen
+    catalog.add(i + 1, name.c_str(), "", (ItemCategory)(i % ITEM_CATEGORY_COUNT), 0, false);
+  }
+}
+
+int main() {
+  std::mt19937 rng(7);
+  const int sizes[] = {100, 1000, 5000, 10000};
+  const char* queries[] = {"karton", "plastic fles", "creme", "wattenstaafje", "xyz"};
+
+  printf("%6s | %9s | %11s | %9s | %9s | %8s\n",
+         "items", "build us", "index bytes", "avg us", "max us", "results");
+  for (int n : sizes) {
+    Catalog catalog;
+    buildCatalog(catalog, n, rng);
+    auto buildStart = Clock::now();
+    catalog.finalize();
+    double buildUs = std::chrono::duration<double, std::micro>(Clock::now() - buildStart).count();
+
+    ItemSearch search;
+    double total = 0, worst = 0;
+    int keystrokes = 0;
+    for (int round = 0; round < 20; round++) {
+      for (const char* q : queries) {
+        std::string typed;
+        for (const char* c = q; *c; c++) {
+          typed += *c;
+          auto start = Clock::now();
+          search.run(catalog, typed.c_str());
+          double us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+          total += us;
+          if (us > worst) worst = us;
+          keystrokes++;
+        }
+      }
+    }
+    search.run(catalog, "k");
+    printf("%6d | %9.0f | %11u | %9.2f | %9.2f | %8u ('k')\n", n, buildUs,
+           (unsigned)catalog.indexBytes(), total / keystrokes, worst, (unsigned)search.size());
+  }
+
+  // Tikfouten: (invoer, bedoeld woord)
+  const char* typos[][2] = {
+    {"alluminium", "aluminium"}, {"bananeschil", "bananenschil"}, {"kofiebeker", "koffiebeker"},
+    {"tandeborstel", "tandenborstel"}, {"wattestaafje", "wattenstaafje"}, {"yogurt", "yoghurt"},
+    {"pizadoos", "pizzadoos"}, {"tijdschrieft", "tijdschrift"}, {"batterei", "batterij"},
+  };
+  const int typoCount = sizeof(typos) / sizeof(typos[0]);
+
+  printf("\nFuzzy (budget %u bytes vs onbeperkt)\n", (unsigned)FUZZY_INDEX_BUDGET);
+  printf("%6s | %9s | %9s | %9s | %7s | %9s | %9s | %5s\n",
+         "items", "budget", "tri bytes", "trigrams", "lijst", "avg us", "max us", "hits");
+  for (int n : sizes) {
+    for (size_t budget : {(size_t)FUZZY_INDEX_BUDGET, (size_t)0}) {
+      Catalog catalog;
+      buildCatalog(catalog, n, rng);
+      catalog.setFuzzyBudget(budget);
+      catalog.finalize();
+      const TrigramIndex& index = catalog.getTrigramIndex();
+
+      ItemSearch search;
+      double total = 0, worst = 0;
+      int hits = 0;
+      for (int round = 0; round < 20; round++) {
+        for (int t = 0; t < typoCount; t++) {
+          auto start = Clock::now();
+          search.run(catalog, typos[t][0]);
+          double us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+          total += us;
+          if (us > worst) worst = us;
+          if (round > 0) continue;
+          for (size_t i = 0; i < search.size(); i++) {
+            if (strstr(catalog.foldedNameOf(search.slotAt(i)), typos[t][1])) { hits++; break; }
+          }
+        }
+      }
+      printf("%6d | %9s | %9u | %9u | %7u | %9.2f | %9.2f | %2d/%d\n", n,
+             budget ? std::to_string(budget).c_str() : "-", (unsigned)index.memoryUsage(),
+             (unsigned)index.trigramCount(), (unsigned)index.getListCap(),
+             total / (20 * typoCount), worst, hits, typoCount);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,67 @@
+// Host benchmark: catalogus opbouwen (add + finalize, zoals na een JSON
+// parse) tegen een binair snapshot koppelen (attach: header, CRC en
+// sectie controle, geen kopie).
+//
+//   g++ -O2 -std=gnu++14 -Isrc tools/bench/snapshot_bench.cpp -o /tmp/snapshot_bench
+//   /tmp/snapshot_bench
+//
+// De JSON parse zelf (ArduinoJson) zit niet in "build"; op het apparaat
+// meet het console commando 'catload' alle paden inclusief LittleFS.
+#include "models/Catalog.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+using Clock = std::chrono::steady_clock;
+
+template <typename F>
+static double usPer(int runs, F f) {
+  auto start = Clock::now();
+  for (int i = 0; i < runs; i++) f();
+  return std::chrono::duration<double, std::micro>(Clock::now() - start).count() / runs;
+}
+
+static void fill(Catalog& catalog, int n) {
+  static const char* descriptions[] = {"Leeg en gespoeld", "Onbeschadigd papier", "Groen bak", ""};
+  std::mt19937 rng(11);
+  catalog.reserve(n);
+  char name[32];
+  for (int i = 0; i < n; i++) {
+    snprintf(name, sizeof(name), "%c%c item %05d", 'A' + (int)(rng() % 26), 'a' + (int)(rng() % 26), i);
+    catalog.add(1 + i * 3, name, descriptions[i % 4], (ItemCategory)(rng() % ITEM_CATEGORY_COUNT), 0, false);
+  }
+}
+
+int main() {
+  const int sizes[] = {100, 1000, 10000};
+  printf("%6s | %10s | %10s | %10s | %12s | %10s\n",
+         "items", "build us", "attach us", "bytes", "build heap", "flash heap");
+  for (int n : sizes) {
+    const int runs = n >= 10000 ? 5 : 50;
+
+    size_t builtHeap = 0;
+    double buildUs = usPer(runs, [&]() {
+      Catalog catalog;
+      fill(catalog, n);
+      catalog.finalize();
+      builtHeap = catalog.heapBytes();
+    });
+
+    Catalog source;
+    fill(source, n);
+    source.finalize();
+    std::vector<uint8_t> snapshot;
+    source.serialize(snapshot);
+
+    size_t mappedHeap = 0;
+    double attachUs = usPer(runs * 10, [&]() {
+      Catalog mapped;
+      if (!mapped.attach(snapshot.data(), snapshot.size())) abort();
+      mappedHeap = mapped.heapBytes();
+    });
+
+    printf("%6d | %10.1f | %10.1f | %10u | %12u | %10u\n", n, buildUs, attachUs,
+           (unsigned)snapshot.size(), (unsigned)builtHeap, (unsigned)mappedHeap);
+  }
+  return 0;
+}
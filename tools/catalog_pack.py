@@ -0,0 +1,328 @@
+"""Zet catalogus.json om naar het binaire catalogus snapshot (CatalogFormat).
+
+Gebruik:
+    python tools/catalog_pack.py data/catalogus.json catalog.bin
+    esptool.py --chip esp32 write_flash 0x340000 catalog.bin
+
+    # Test catalogus met synthetische items (bijv. voor 'catpage')
+    python tools/catalog_pack.py --synthetic 5000 - catalog.bin
+
+0x340000 is de 'catalog' partitie uit partitions.csv. Bij het opstarten
+wordt die partitie gemapt en zonder parse gebruikt (zie
+ItemRepository::loadFromPartition). Hetzelfde bestand werkt ook als
+/db_cache.bin in LittleFS.
+
+Bouwt exact dezelfde indexen als Catalog::finalize() in
+src/models/Catalog.h; wijzigingen daar moeten hier ook gebeuren (en
+CatalogFormat::VERSION omhoog als de layout verandert).
+"""
+import argparse
+import json
+import random
+import struct
+import sys
+import zlib
+
+MAGIC = 0x54434252  # "RBCT"
+VERSION = 3  # 3: CRC over het hele bestand (crc32 veld als nullen)
+LETTER_BUCKETS = 27
+CATEGORY_COUNT = 4
+MAX_ITEMS = 65535
+FOLD_BUFFER = 96              # Catalog::buildWordIndex
+FUZZY_INDEX_BUDGET = 24 * 1024  # config.h
+TRIGRAM_SYMBOLS = 37
+
+HEADER = struct.Struct("<IHHIIIII5H28HH20I")
+ITEM = struct.Struct("<iIIHBB")
+WORD_START = struct.Struct("<IHH")
+
+# U+00C0..U+00FF -> ASCII basisletter, ' ' = scheidingsteken (TextFold.h)
+LATIN1_BASE = ("aaaaaaaceeeeiiiidnooooo ouuuuyts"
+               "aaaaaaaceeeeiiiidnooooo ouuuuyty")
+
+CATEGORIES = {
+    "plastic": 0,
+    "paper": 1, "papier": 1,
+    "green": 2, "groen": 2, "gft": 2,
+    "waste": 3, "rest": 3, "restafval": 3,
+}
+
+
+def fold(text, out_size=FOLD_BUFFER):
+    """TextFold::fold: kleine letters, accenten weg, scheidingstekens -> één spatie"""
+    out = bytearray()
+    pending = False
+    i = 0
+    while i < len(text) and len(out) + 1 < out_size:
+        b = text[i]
+        c = None
+        if b < 0x80:
+            if chr(b).isascii() and chr(b).isalnum():
+                c = chr(b).lower()
+            i += 1
+        elif b == 0xC3 and i + 1 < len(text) and 0x80 <= text[i + 1] <= 0xBF:
+            c = LATIN1_BASE[text[i + 1] - 0x80]
+            if c == " ":
+                c = None
+            i += 2
+        else:
+            i += 1
+            while i < len(text) and (text[i] & 0xC0) == 0x80:
+                i += 1
+
+        if c is None:
+            pending = len(out) > 0
+            continue
+        if pending:
+            if len(out) + 2 >= out_size:
+                break
+            out += b" "
+            pending = False
+        out += c.encode()
+    return bytes(out)
+
+
+def letter_bucket(name):
+    c = name[:1].upper()
+    return c[0] - ord("A") if c and b"A" <= c <= b"Z" else LETTER_BUCKETS - 1
+
+
+def hash_id(item_id, mask):
+    return ((item_id & 0xFFFFFFFF) * 2654435761) & 0xFFFFFFFF & mask
+
+
+def trigram_symbol(c):
+    if ord("a") <= c <= ord("z"):
+        return 1 + c - ord("a")
+    if ord("0") <= c <= ord("9"):
+        return 27 + c - ord("0")
+    return 0
+
+
+def trigrams(text):
+    """TrigramIndex::forEachTrigram over " text " """
+    if not text:
+        return
+    a, b = 0, trigram_symbol(text[0])
+    for i in range(1, len(text) + 1):
+        c = trigram_symbol(text[i]) if i < len(text) else 0
+        yield (a * TRIGRAM_SYMBOLS + b) * TRIGRAM_SYMBOLS + c
+        a, b = b, c
+
+
+class StringArena:
+    """Offset 0 = lege string; dubbele strings één keer (StringArena::intern)"""
+
+    def __init__(self):
+        self.data = bytearray(b"\0")
+        self.offsets = {}
+
+    def intern(self, s):
+        if not s:
+            return 0
+        if s not in self.offsets:
+            self.offsets[s] = len(self.data)
+            self.data += s + b"\0"
+        return self.offsets[s]
+
+
+def parse_color(value):
+    try:
+        return int(value, 16) & 0xFFFF
+    except ValueError:
+        return 0
+
+
+def load_items(path):
+    """Zelfde defaults als ItemRepository::parseJSONFile"""
+    with open(path, encoding="utf-8") as f:
+        doc = json.load(f)
+    items = []
+    for obj in doc.get("items", [])[:MAX_ITEMS]:
+        name = obj.get("name")
+        items.append({
+            "id": int(obj.get("id") or 0),
+            "name": (name if name is not None else "Unknown").encode(),
+            "description": (obj.get("description") or "").encode(),
+            "category": CATEGORIES.get(str(obj.get("category") or "waste").lower(), 3),
+            "color": parse_color(obj.get("color") or "0x6B4D"),
+            "canBeDirty": bool(obj.get("canBeDirty", False)),
+        })
+    return items
+
+
+def synthetic_items(count):
+    """Test catalogus van willekeurige namen (zelfde vorm als snapshot_bench)"""
+    rng = random.Random(11)
+    words = ["fles", "doos", "zak", "blik", "pot", "folie", "beker", "krant",
+             "schil", "resten", "dop", "bak", "tube", "karton", "glas", "verpakking"]
+    categories = ["plastic", "papier", "gft", "restafval"]
+    items = []
+    for i in range(count):
+        name = "%s%s %s %05d" % (chr(65 + rng.randrange(26)), rng.choice(words),
+                                 rng.choice(words), i)
+        items.append({
+            "id": 1 + i * 3,
+            "name": name.encode(),
+            "description": ("Test item %d" % i).encode() if i % 4 else b"",
+            "category": CATEGORIES[categories[rng.randrange(4)]],
+            "color": 0x6B4D,
+            "canBeDirty": i % 3 == 0,
+        })
+    return items
+
+
+def build_trigram_index(folded, budget):
+    """TrigramIndex::build: posting lijsten inkorten tot ze in het budget passen"""
+    pairs = sorted({(key << 16) | slot for slot, text in enumerate(folded) for key in trigrams(text)})
+    group_start = [i for i in range(len(pairs)) if i == 0 or (pairs[i] >> 16) != (pairs[i - 1] >> 16)]
+    groups = len(group_start)
+    group_start.append(len(pairs))
+
+    def bytes_for(keys, postings):
+        return keys * 6 + 4 + postings * 2
+
+    def postings_with_cap(cap):
+        return sum(min(group_start[g + 1] - group_start[g], cap) for g in range(groups))
+
+    cap = len(pairs)
+    list_cap = 0
+    kept = groups
+    if budget > 0 and bytes_for(groups, len(pairs)) > budget:
+        lo, hi = 1, len(pairs)
+        while lo < hi:
+            mid = (lo + hi + 1) // 2
+            if bytes_for(groups, postings_with_cap(mid)) <= budget:
+                lo = mid
+            else:
+                hi = mid - 1
+        cap = list_cap = lo
+        if bytes_for(groups, postings_with_cap(cap)) > budget:
+            while kept > 0 and bytes_for(kept, kept) > budget:
+                kept -= 1
+
+    keys, starts, postings = [], [], []
+    for g in range(kept):
+        keys.append(pairs[group_start[g]] >> 16)
+        starts.append(len(postings))
+        end = min(group_start[g + 1], group_start[g] + cap)
+        postings.extend(p & 0xFFFF for p in pairs[group_start[g]:end])
+    starts.append(len(postings))
+    return keys, starts, postings, list_cap, groups - kept
+
+
+def pack(items, budget, data_version=0):
+    # Catalog::finalize: A-Z per letter bucket
+    items.sort(key=lambda it: (letter_bucket(it["name"]), it["name"], it["id"]))
+    n = len(items)
+
+    # Catalog::serialize: strings in slot volgorde, eerst namen dan beschrijvingen
+    arena = StringArena()
+    for item in items:
+        item["nameOffset"] = arena.intern(item["name"])
+    for item in items:
+        item["descriptionOffset"] = arena.intern(item["description"])
+
+    letter_start = [0] * (LETTER_BUCKETS + 1)
+    for item in items:
+        letter_start[letter_bucket(item["name"]) + 1] += 1
+    for b in range(LETTER_BUCKETS):
+        letter_start[b + 1] += letter_start[b]
+
+    category_start = [0] * (CATEGORY_COUNT + 1)
+    for item in items:
+        category_start[item["category"] + 1] += 1
+    for c in range(CATEGORY_COUNT):
+        category_start[c + 1] += category_start[c]
+    category_slots = [slot for c in range(CATEGORY_COUNT)
+                      for slot, item in enumerate(items) if item["category"] == c]
+
+    table_size = 16
+    while table_size < n + n // 2:
+        table_size <<= 1
+    id_table = [0] * table_size
+    mask = table_size - 1
+    for slot, item in enumerate(items):
+        i = hash_id(item["id"], mask)
+        while id_table[i]:
+            i = (i + 1) & mask
+        id_table[i] = slot + 1
+
+    folded_names = bytearray()
+    folded_start = []
+    folded = []
+    words = []
+    for slot, item in enumerate(items):
+        text = fold(item["name"])
+        base = len(folded_names)
+        folded.append(text)
+        folded_start.append(base)
+        folded_names += text + b"\0"
+        words.extend((base + i, slot) for i in range(len(text)) if i == 0 or text[i - 1] == 0x20)
+    words.sort(key=lambda w: (bytes(folded_names[w[0]:folded_names.index(0, w[0])]), w[1]))
+
+    keys, starts, postings, list_cap, dropped = build_trigram_index(folded, budget)
+
+    sections = [
+        b"".join(ITEM.pack(it["id"], it["nameOffset"], it["descriptionOffset"], it["color"],
+                           it["category"], it["canBeDirty"]) for it in items),
+        bytes(arena.data),
+        struct.pack("<%dH" % len(id_table), *id_table),
+        struct.pack("<%dH" % n, *category_slots),
+        bytes(folded_names),
+        struct.pack("<%dI" % n, *folded_start),
+        b"".join(WORD_START.pack(offset, slot, 0) for offset, slot in words),
+        struct.pack("<%dH" % len(keys), *keys),
+        struct.pack("<%dI" % len(starts), *starts),
+        struct.pack("<%dH" % len(postings), *postings),
+    ]
+    counts = [n, len(arena.data), table_size, n, len(folded_names), n, len(words),
+              len(keys), len(starts), len(postings)]
+
+    body = bytearray(HEADER.size)
+    refs = []
+    for data, count in zip(sections, counts):
+        body += b"\0" * (-len(body) % 4)
+        refs += [len(body), count]
+        body += data
+    body += b"\0" * (-len(body) % 4)
+
+    def header(crc):
+        return HEADER.pack(MAGIC, VERSION, HEADER.size, len(body), crc, n, list_cap,
+                           data_version, *category_start, *letter_start, 0, *refs)
+
+    body[:HEADER.size] = header(0)
+    body[:HEADER.size] = header(zlib.crc32(bytes(body)) & 0xFFFFFFFF)
+    stats = {"items": n, "strings": len(arena.data), "words": len(words),
+             "trigrams": len(keys), "postings": len(postings), "list_cap": list_cap,
+             "dropped": dropped}
+    return bytes(body), stats
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("input", help="catalogus.json ('-' met --synthetic)")
+    parser.add_argument("output", help="binair snapshot (.bin)")
+    parser.add_argument("--fuzzy-budget", type=int, default=FUZZY_INDEX_BUDGET,
+                        help="max bytes trigram index (FUZZY_INDEX_BUDGET, 0 = onbeperkt)")
+    parser.add_argument("--data-version", type=int, default=0,
+                        help="catalogus versie van de API (0 = onbekend, eerste sync is volledig)")
+    parser.add_argument("--synthetic", type=int, default=0,
+                        help="negeer input en maak N test items")
+    parser.add_argument("--partition-size", type=lambda v: int(v, 0), default=0xB0000,
+                        help="grootte van de catalog partitie (partitions.csv)")
+    args = parser.parse_args()
+
+    items = synthetic_items(args.synthetic) if args.synthetic else load_items(args.input)
+    data, stats = pack(items, args.fuzzy_budget, args.data_version)
+    if len(data) > args.partition_size:
+        sys.exit("snapshot is %d bytes, partitie maar %d" % (len(data), args.partition_size))
+    with open(args.output, "wb") as f:
+        f.write(data)
+
+    print("%s: %d bytes, %s" % (args.output, len(data),
+                               ", ".join("%s=%s" % kv for kv in stats.items())))
+
+
+if __name__ == "__main__":
+    main()
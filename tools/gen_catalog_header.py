@@ -0,0 +1,70 @@
+"""Zet data/catalogus.json om naar src/generated/CatalogBuiltin.h.
+
+PlatformIO pre-build script (platformio.ini: extra_scripts), maar ook los
+te draaien:
+    python tools/gen_catalog_header.py
+
+De header bevat het binaire catalogus snapshot (zelfde formaat als
+tools/catalog_pack.py: al gesorteerd, met alle indexen) als const array.
+Die staat in flash (rodata) en wordt bij het opstarten zonder parse en
+zonder heap gekoppeld als laatste fallback (ItemRepository::loadBuiltinItems),
+ook op een apparaat met een leeg filesysteem.
+
+Het bestand wordt alleen herschreven als de inhoud verandert, zodat een
+build zonder gewijzigde catalogus niets opnieuw compileert.
+"""
+import os
+import sys
+
+try:
+    Import("env")  # noqa: F821 - PlatformIO/SCons
+    PROJECT_DIR = env["PROJECT_DIR"]  # noqa: F821
+except NameError:
+    PROJECT_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+sys.path.insert(0, os.path.join(PROJECT_DIR, "tools"))
+import catalog_pack  # noqa: E402
+
+SOURCE = os.path.join(PROJECT_DIR, "data", "catalogus.json")
+TARGET = os.path.join(PROJECT_DIR, "src", "generated", "CatalogBuiltin.h")
+BYTES_PER_LINE = 16
+
+
+def render(data, stats):
+    lines = [
+        "// Gegenereerd door tools/gen_catalog_header.py uit data/catalogus.json",
+        "// Niet bewerken; wordt bij elke build opnieuw gemaakt.",
+        "#ifndef CATALOG_BUILTIN_H",
+        "#define CATALOG_BUILTIN_H",
+        "",
+        "#include <Arduino.h>",
+        "",
+        "#define CATALOG_BUILTIN_ITEMS %d" % stats["items"],
+        "",
+        "// Snapshot in CatalogFormat (v%d), 4-byte uitgelijnd voor Catalog::attach"
+        % catalog_pack.VERSION,
+        "alignas(4) static const uint8_t CATALOG_BUILTIN[%d] PROGMEM = {" % len(data),
+    ]
+    for i in range(0, len(data), BYTES_PER_LINE):
+        chunk = data[i:i + BYTES_PER_LINE]
+        lines.append("  " + ", ".join("0x%02x" % b for b in chunk) + ",")
+    lines += ["};", "", "#endif", ""]
+    return "\n".join(lines)
+
+
+def generate():
+    data, stats = catalog_pack.pack(catalog_pack.load_items(SOURCE),
+                                    catalog_pack.FUZZY_INDEX_BUDGET)
+    text = render(data, stats)
+
+    if os.path.exists(TARGET):
+        with open(TARGET, encoding="utf-8") as f:
+            if f.read() == text:
+                return
+    os.makedirs(os.path.dirname(TARGET), exist_ok=True)
+    with open(TARGET, "w", encoding="utf-8", newline="\n") as f:
+        f.write(text)
+    print("CatalogBuiltin.h: %d items, %d bytes" % (stats["items"], len(data)))
+
+
+generate()
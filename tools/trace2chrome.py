@@ -0,0 +1,87 @@
+"""Zet een 'trace' dump van de serial console om naar Chrome trace_event JSON.
+
+Gebruik:
+    pio device monitor | tee serial.log     (typ 'trace' in de monitor)
+    python tools/trace2chrome.py serial.log > trace.json
+
+Open trace.json in https://ui.perfetto.dev of chrome://tracing.
+"""
+import json
+import sys
+
+
+def parse_dump(lines):
+    """Geef (ts_us, phase, core, name) tuples terug uit de laatste volledige
+    dump (BEGIN t/m END) in de log; een afgebroken dump aan het eind telt niet"""
+    last = []
+    records = None
+    for raw in lines:
+        line = raw.strip()
+        if line.startswith("# TRACE BEGIN"):
+            records = []
+            continue
+        if line.startswith("# TRACE END"):
+            if records is not None:
+                last = records
+            records = None
+            continue
+        if records is None or not line:
+            continue
+        parts = line.split(" ", 3)
+        if len(parts) != 4:
+            continue
+        ts, phase, core, name = parts
+        records.append((int(ts), phase, int(core), name))
+    return last
+
+
+def to_trace_events(records):
+    events = []
+    open_spans = {}  # (core, name) -> diepte, om losse END records te filteren
+    offset = 0
+    last_ts = None
+
+    for ts, phase, core, name in records:
+        # micros() loopt na ~71 minuten over
+        if last_ts is not None and ts + offset < last_ts - (1 << 31):
+            offset += 1 << 32
+        ts += offset
+        last_ts = ts
+
+        key = (core, name)
+        if phase == "B":
+            open_spans[key] = open_spans.get(key, 0) + 1
+        elif phase == "E":
+            if open_spans.get(key, 0) == 0:
+                continue  # BEGIN is al overschreven in de ring buffer
+            open_spans[key] -= 1
+
+        event = {"name": name, "ph": phase, "ts": ts, "pid": 1, "tid": core}
+        if phase == "i":
+            event["s"] = "t"
+        events.append(event)
+
+    return {
+        "traceEvents": events,
+        "displayTimeUnit": "ms",
+        "otherData": {"source": "recyclebin-esp"},
+    }
+
+
+def main():
+    if len(sys.argv) > 1:
+        with open(sys.argv[1], "r", encoding="utf-8", errors="replace") as f:
+            records = parse_dump(f)
+    else:
+        records = parse_dump(sys.stdin)
+
+    if not records:
+        print("No '# TRACE BEGIN' block found", file=sys.stderr)
+        sys.exit(1)
+
+    json.dump(to_trace_events(records), sys.stdout, indent=1)
+    print(f"Converted {len(records)} records", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()